@@ -0,0 +1,98 @@
+// copyBufferSubdataOverlapping: checks every path against memmove, then times one copy per step against bouncing through the scratch buffer.
+// Exits with a failure if any result differs from memmove.
+
+#include "Window.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace gl;
+
+constexpr GLsizeiptr kBufferBytes = 8 << 20;
+
+static std::vector<uint8_t> pattern() {
+	std::vector<uint8_t> result(kBufferBytes);
+	uint32_t x = 0x12345678;
+	for(uint8_t& b : result) {
+		x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+		b = uint8_t(x);
+	}
+	return result;
+}
+
+// Moves with one of the paths and compares the whole buffer with memmove doing the same on the CPU
+static bool check(ArrayBuffer& buffer, std::vector<uint8_t> const& initial, char const* path, GLintptr src, GLintptr dst, GLsizeiptr size, GLuint scratch, GLsizeiptr scratchSize) {
+	buffer.subdata(0, initial.size(), initial.data());
+	if(path[0] == 'p') copyBufferSubdataOverlapping(buffer, src, dst, size);
+	else               copyBufferSubdataOverlapping(buffer, src, dst, size, scratch, scratchSize);
+
+	std::vector<uint8_t> expected = initial, actual(initial.size());
+	std::memmove(expected.data() + dst, expected.data() + src, size_t(size));
+	buffer.getData(0, actual.size(), actual.data());
+	if(actual == expected) return true;
+
+	std::printf("FAILED %-8s %s %8ld bytes by %6ld, scratch %6ld\n", path, dst < src ? "backward" : "forward ", long(size), long(std::abs(dst - src)), long(scratchSize));
+	return false;
+}
+
+int main() {
+	GLFWwindow* window = createBenchmarkWindow("CopyOverlapping benchmark");
+	if(!window) return EXIT_FAILURE;
+
+	std::printf("%s\n", (const char*) glGetString(GL_RENDERER));
+
+	ArrayBuffer buffer;
+	buffer.storage(STORAGE_DYNAMIC_BIT, kBufferBytes);
+	std::vector<uint8_t> initial = pattern();
+
+	constexpr GLsizeiptr kScratchBytes = 4096;
+	ArrayBuffer scratch;
+	scratch.storage(STORAGE_DEFAULT, kScratchBytes);
+
+	// Sizes that aren't multiples of the scratch or the step, shifts below, at and above the scratch size
+	int checks = 0, failures = 0;
+	for(GLsizeiptr size : { GLsizeiptr(1000), GLsizeiptr(kScratchBytes), GLsizeiptr(3 * kScratchBytes + 123), GLsizeiptr((1 << 20) + 77) }) {
+		for(GLintptr shift : { GLintptr(1), GLintptr(100), GLintptr(kScratchBytes - 1), GLintptr(kScratchBytes), GLintptr(kScratchBytes + 1), GLintptr(3 * kScratchBytes + 5) }) {
+			for(bool forward : { true, false }) {
+				GLintptr src = forward ? 17 : 17 + shift;
+				GLintptr dst = forward ? 17 + shift : 17;
+				if(size / shift <= 10000) { // The in place path takes size / shift copies
+					failures += !check(buffer, initial, "in place", src, dst, size, 0, 0);
+					checks++;
+				}
+				failures += !check(buffer, initial, "scratch", src, dst, size, scratch, kScratchBytes);
+				failures += !check(buffer, initial, "pooled", src, dst, size, 0, 0);
+				checks += 2;
+			}
+		}
+	}
+	std::printf("%d of %d moves match memmove\n\n", checks - failures, checks);
+
+	using Clock = std::chrono::steady_clock;
+	std::printf("%-22s %12s %12s %12s\n", "move", "in place", "scratch", "speedup");
+	for(GLsizeiptr size : { GLsizeiptr(1 << 20), GLsizeiptr(4 << 20) }) {
+		for(GLintptr shift : { GLintptr(64), GLintptr(1024), GLintptr(65536) }) {
+			auto time = [&](bool pooledScratch) {
+				glFinish();
+				auto start = Clock::now();
+				if(pooledScratch) copyBufferSubdataOverlapping(buffer, shift, 0, size);
+				else              copyBufferSubdataOverlapping(buffer, shift, 0, size, 0, 0);
+				glFinish();
+				return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			};
+			time(true); // Grows the pooled scratch buffer outside of the measurement
+			double inPlace = time(false);
+			double pooled  = time(true);
+			char name[32];
+			std::snprintf(name, sizeof(name), "%ld MiB by %ld", long(size >> 20), long(shift));
+			std::printf("%-22s %9.2f ms %9.2f ms %11.1fx\n", name, inPlace, pooled, inPlace / pooled);
+		}
+	}
+
+	releaseCopyScratchBuffer();
+	destroyBenchmarkWindow(window);
+	return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
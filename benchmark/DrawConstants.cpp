@@ -0,0 +1,156 @@
+// Per-object constants: glProgramUniform* per draw (like example/Main.cpp) vs. DrawConstants with bindRange vs. one SSBO indexed by gl_BaseInstance.
+// Prints the CPU time spent submitting a frame and the time until the GPU finished it.
+
+#include "Window.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace gl;
+
+constexpr int kObjects = 10000;
+constexpr int kFrames  = 100;
+
+struct Object {
+	Matrix<float, 4> model;
+	Vector<float, 4> color;
+};
+
+static const char* kFragment = R"(#version 450
+in vec4 vColor;
+out vec4 outColor;
+void main() { outColor = vColor; }
+)";
+
+static const char* kVertexUniforms = R"(#version 450
+uniform mat4 uModel;
+uniform vec4 uColor;
+out vec4 vColor;
+void main() {
+	vec2 corner = vec2(gl_VertexID == 1, gl_VertexID == 2) * 0.01;
+	gl_Position = uModel * vec4(corner, 0, 1);
+	vColor = uColor;
+}
+)";
+
+static const char* kVertexUniformBlock = R"(#version 450
+layout(std140, binding = 1) uniform Object { mat4 model; vec4 color; };
+out vec4 vColor;
+void main() {
+	vec2 corner = vec2(gl_VertexID == 1, gl_VertexID == 2) * 0.01;
+	gl_Position = model * vec4(corner, 0, 1);
+	vColor = color;
+}
+)";
+
+static const char* kVertexStorageBlock = R"(#version 450
+#extension GL_ARB_shader_draw_parameters : require
+struct Object { mat4 model; vec4 color; };
+layout(std430, binding = 1) readonly buffer Objects { Object objects[]; };
+out vec4 vColor;
+void main() {
+	Object o = objects[gl_BaseInstanceARB];
+	vec2 corner = vec2(gl_VertexID == 1, gl_VertexID == 2) * 0.01;
+	gl_Position = o.model * vec4(corner, 0, 1);
+	vColor = o.color;
+}
+)";
+
+static Object objectAt(int i, int frame) {
+	float x = float(i % 100) / 50.f - 1.f;
+	float y = float(i / 100 % 100) / 50.f - 1.f;
+	float s = 1.f + 0.5f * std::sin(float(frame + i) * 0.1f);
+	return {
+		{ s,0,0,0, 0,s,0,0, 0,0,1,0, x,y,0,1 },
+		{ float(i & 1), float(i & 2) / 2.f, float(frame & 1), 1 }
+	};
+}
+
+template<class DrawFrame>
+static void measure(const char* name, GLFWwindow* window, DrawFrame&& drawFrame) {
+	using Clock = std::chrono::steady_clock;
+	double submitMs = 0, frameMs = 0;
+	for(int frame = -10; frame < kFrames; frame++) { // 10 frames warm up
+		auto start = Clock::now();
+		glClear(GL_COLOR_BUFFER_BIT);
+		drawFrame(frame);
+		auto submitted = Clock::now();
+		glFinish();
+		auto finished = Clock::now();
+		glfwSwapBuffers(window);
+
+		if(frame >= 0) {
+			submitMs += std::chrono::duration<double, std::milli>(submitted - start).count();
+			frameMs  += std::chrono::duration<double, std::milli>(finished  - start).count();
+		}
+	}
+	std::printf("%-30s submit %7.3f ms/frame (%6.1f ns/draw), frame %7.3f ms\n",
+		name, submitMs / kFrames, submitMs / kFrames / kObjects * 1e6, frameMs / kFrames);
+}
+
+int main() {
+	GLFWwindow* window = createBenchmarkWindow("DrawConstants benchmark");
+	if(!window) return EXIT_FAILURE;
+
+	std::printf("%s, %d draws per frame\n", (const char*) glGetString(GL_RENDERER), kObjects);
+
+	gl::VertexArray empty;
+	empty.bind();
+
+	{
+		gl::Program program = {
+			gl::VertexShader(kVertexUniforms),
+			gl::FragmentShader(kFragment)
+		};
+		program.use();
+		int uModel = program.uniformLocation("uModel"_u);
+		int uColor = program.uniformLocation("uColor"_u);
+		measure("Program::uniform", window, [&](int frame) {
+			for(int i = 0; i < kObjects; i++) {
+				Object o = objectAt(i, frame);
+				program.uniform(uModel, o.model);
+				program.uniform(uColor, o.color);
+				drawArrays(TRIANGLES, 3);
+			}
+		});
+	}
+
+	{
+		gl::Program program = {
+			gl::VertexShader(kVertexUniformBlock),
+			gl::FragmentShader(kFragment)
+		};
+		program.use();
+		gl::UniformConstants constants(3 * kObjects * 256); // Three frames, 256 bytes covers every UNIFORM_BUFFER_OFFSET_ALIGNMENT
+		measure("UniformConstants::bind", window, [&](int frame) {
+			for(int i = 0; i < kObjects; i++) {
+				constants.bind(1, constants.push(objectAt(i, frame)));
+				drawArrays(TRIANGLES, 3);
+			}
+			constants.retire();
+		});
+	}
+
+	if(GLEW_ARB_shader_draw_parameters) {
+		gl::Program program = {
+			gl::VertexShader(kVertexStorageBlock),
+			gl::FragmentShader(kFragment)
+		};
+		program.use();
+		gl::StorageConstants constants(3 * kObjects * sizeof(Object) + 256);
+		measure("StorageConstants+baseInstance", window, [&](int frame) {
+			auto objects = constants.allocateArray(kObjects, sizeof(Object));
+			for(int i = 0; i < kObjects; i++)
+				static_cast<Object*>(objects.data)[i] = objectAt(i, frame);
+			constants.bind(1, objects);
+			for(int i = 0; i < kObjects; i++)
+				drawArraysInstancedBaseInstance(1, i, TRIANGLES, 3);
+			constants.retire();
+		});
+	}
+
+	destroyBenchmarkWindow(window);
+	return EXIT_SUCCESS;
+}
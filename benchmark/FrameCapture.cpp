@@ -0,0 +1,114 @@
+// Render thread time of capturing every frame to a PNG: glReadPixels and stb_image_write on the render thread
+// vs. gl::FrameCapture reading into mapped PIXEL_PACK_BUFFERs and encoding on a ThreadPool.
+// The PNGs go to the temp directory and are removed afterwards.
+
+#include "Window.hpp"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "example/thirdparty/stb_image_write.h"
+
+#include <glpp-io-util.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace gl;
+
+constexpr int kWidth  = 1280;
+constexpr int kHeight = 720;
+constexpr int kFrames = 60;
+
+static const char* kVertex = R"(#version 450
+void main() {
+	vec2 uv = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2;
+	gl_Position = vec4(uv * 2 - 1, 0, 1);
+}
+)";
+
+static const char* kFragment = R"(#version 450
+uniform float uTime;
+out vec4 outColor;
+void main() {
+	vec2 p = gl_FragCoord.xy / vec2(1280, 720);
+	outColor = vec4(0.5 + 0.5 * sin(p.x * 10 + uTime), 0.5 + 0.5 * cos(p.y * 7 - uTime), p.x * p.y, 1);
+}
+)";
+
+using Clock = std::chrono::steady_clock;
+static double milliseconds(Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); }
+
+int main() {
+	GLFWwindow* window = createBenchmarkWindow("FrameCapture benchmark");
+	if(!window) return EXIT_FAILURE;
+
+	ThreadPool pool;
+	std::printf("%s, %dx%d, %d frames, %u threads\n", (const char*) glGetString(GL_RENDERER), kWidth, kHeight, kFrames, pool.size());
+
+	Renderbuffer color(RGBA8, kWidth, kHeight);
+	Framebuffer  framebuffer;
+	framebuffer.renderbuffer(COLOR_ATTACHMENT0, color);
+	framebuffer.assertStatus();
+	framebuffer.bind();
+	glViewport(0, 0, kWidth, kHeight);
+
+	VertexArray empty;
+	empty.bind();
+	Program program{ VertexShader(kVertex), FragmentShader(kFragment) };
+	program.use();
+
+	std::string directory = std::filesystem::temp_directory_path().string() + "/glpp-frame-capture";
+	std::filesystem::create_directories(directory);
+	auto path = [&](char const* prefix, int frame) { return directory + "/" + prefix + std::to_string(frame) + ".png"; };
+
+	auto draw = [&](int frame) {
+		glUniform1f(glGetUniformLocation(program, "uTime"), float(frame) * 0.1f);
+		drawArrays(TRIANGLES, 3);
+	};
+
+	// Blocking: the render thread waits for the GPU, then encodes
+	{
+		std::vector<uint8_t> pixels(size_t(kWidth) * kHeight * 3);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		double worst = 0;
+		auto start = Clock::now();
+		for(int frame = 0; frame < kFrames; frame++) {
+			auto frameStart = Clock::now();
+			draw(frame);
+			glReadPixels(0, 0, kWidth, kHeight, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+			stbi_write_png(path("blocking", frame).c_str(), kWidth, kHeight, 3, pixels.data() + size_t(kHeight - 1) * kWidth * 3, -kWidth * 3);
+			worst = std::max(worst, milliseconds(Clock::now() - frameStart));
+		}
+		double total = milliseconds(Clock::now() - start);
+		std::printf("%-32s %8.2f ms/frame, worst %8.2f ms\n", "glReadPixels + stbi_write_png", total / kFrames, worst);
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	}
+
+	// FrameCapture: the render thread only issues reads
+	{
+		FrameCapture capture(pool, 4);
+		double worst = 0;
+		auto start = Clock::now();
+		for(int frame = 0; frame < kFrames; frame++) {
+			auto frameStart = Clock::now();
+			draw(frame);
+			(void) CapturePng(capture, framebuffer, 0, 0, kWidth, kHeight, path("async", frame));
+			capture.update();
+			glFlush();
+			worst = std::max(worst, milliseconds(Clock::now() - frameStart));
+		}
+		double submitted = milliseconds(Clock::now() - start);
+		capture.finish();
+		double total = milliseconds(Clock::now() - start);
+		std::printf("%-32s %8.2f ms/frame, worst %8.2f ms (%zu captured, %zu dropped, %.0f ms until all PNGs were written)\n", "FrameCapture + CapturePng",
+			submitted / kFrames, worst, capture.stats().captures, capture.stats().dropped, total);
+	}
+
+	std::filesystem::remove_all(directory);
+	framebuffer.unbind();
+	destroyBenchmarkWindow(window);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+// M vertex variants combined with N fragment variants: M×N monolithic programs vs. M+N separable programs combined by gl::Pipeline.
+// Prints the time spent building everything, then the CPU time of a frame switching the combination every draw.
+
+#include "Window.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace gl;
+
+constexpr int kVertexVariants   = 8;
+constexpr int kFragmentVariants = 8;
+constexpr int kDraws            = 10000;
+constexpr int kFrames           = 100;
+
+static const char* kVertex = R"(
+out gl_PerVertex { vec4 gl_Position; };
+layout(location = 0) out vec4 vColor;
+void main() {
+	vec2 corner = vec2(gl_VertexID == 1, gl_VertexID == 2) * 0.05;
+	gl_Position = vec4(corner + vec2(VARIANT / 8.0 - 0.5), 0, 1);
+	vColor = vec4(corner * 20.0, VARIANT / 8.0, 1);
+}
+)";
+
+static const char* kFragment = R"(
+layout(location = 0) in vec4 vColor;
+out vec4 outColor;
+void main() { outColor = vColor * (VARIANT + 1.0) / 8.0; }
+)";
+
+static std::string variant(const char* source, int i) {
+	return "#version 450\n#define VARIANT " + std::to_string(i) + ".0\n" + source;
+}
+
+static Program separableProgram(Shader& shader) {
+	Program result;
+	result.separable();
+	result.attach(shader);
+	(void) result.link();
+	result.detach(shader);
+	result.assertLinked();
+	return result;
+}
+
+using Clock = std::chrono::steady_clock;
+static double milliseconds(Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); }
+
+template<class DrawFrame>
+static void measure(const char* name, GLFWwindow* window, DrawFrame&& drawFrame) {
+	double submitMs = 0;
+	for(int frame = -10; frame < kFrames; frame++) { // 10 frames warm up
+		glClear(GL_COLOR_BUFFER_BIT);
+		auto start = Clock::now();
+		drawFrame();
+		auto submitted = Clock::now();
+		glFinish();
+		glfwSwapBuffers(window);
+		if(frame >= 0) submitMs += milliseconds(submitted - start);
+	}
+	std::printf("%-30s submit %7.3f ms/frame (%6.1f ns/draw)\n", name, submitMs / kFrames, submitMs / kFrames / kDraws * 1e6);
+}
+
+int main() {
+	GLFWwindow* window = createBenchmarkWindow("Pipeline benchmark");
+	if(!window) return EXIT_FAILURE;
+
+	std::printf("%s, %d vertex x %d fragment variants, %d draws per frame\n",
+		(const char*) glGetString(GL_RENDERER), kVertexVariants, kFragmentVariants, kDraws);
+
+	gl::VertexArray empty;
+	empty.bind();
+
+	// Compiling is the same for both, only linking differs
+	std::vector<Shader> vertexShaders, fragmentShaders;
+	for(int i = 0; i < kVertexVariants; i++)   vertexShaders.emplace_back(VERTEX_SHADER, variant(kVertex, i));
+	for(int i = 0; i < kFragmentVariants; i++) fragmentShaders.emplace_back(FRAGMENT_SHADER, variant(kFragment, i));
+
+	auto start = Clock::now();
+	std::vector<Program> programs;
+	for(Shader& v : vertexShaders)
+		for(Shader& f : fragmentShaders)
+			programs.push_back(Program{ v, f });
+	std::printf("%-30s %9.1f ms (%zu links)\n", "Monolithic programs", milliseconds(Clock::now() - start), programs.size());
+
+	start = Clock::now();
+	std::vector<Program> vertexPrograms, fragmentPrograms;
+	for(Shader& v : vertexShaders)   vertexPrograms.push_back(separableProgram(v));
+	for(Shader& f : fragmentShaders) fragmentPrograms.push_back(separableProgram(f));
+	PipelineCache cache;
+	std::vector<Pipeline*> pipelines;
+	for(Program& v : vertexPrograms)
+		for(Program& f : fragmentPrograms)
+			pipelines.push_back(&cache.pipeline({ { VERTEX_SHADER, v }, { FRAGMENT_SHADER, f } }));
+	std::printf("%-30s %9.1f ms (%zu links, %zu pipelines)\n", "Separable programs+Pipeline",
+		milliseconds(Clock::now() - start), vertexPrograms.size() + fragmentPrograms.size(), cache.size());
+	pipelines.front()->assertValid();
+
+	auto combination = [](int draw) { return draw * 7 % (kVertexVariants * kFragmentVariants); };
+
+	measure("Program::use", window, [&] {
+		for(int i = 0; i < kDraws; i++) {
+			programs[combination(i)].use();
+			drawArrays(TRIANGLES, 3);
+		}
+	});
+	Program::unuse();
+
+	measure("Pipeline::bind", window, [&] {
+		for(int i = 0; i < kDraws; i++) {
+			pipelines[combination(i)]->bind();
+			drawArrays(TRIANGLES, 3);
+		}
+	});
+
+	measure("PipelineCache::pipeline+bind", window, [&] {
+		for(int i = 0; i < kDraws; i++) {
+			int c = combination(i);
+			cache.pipeline({
+				{ VERTEX_SHADER,   vertexPrograms[c / kFragmentVariants] },
+				{ FRAGMENT_SHADER, fragmentPrograms[c % kFragmentVariants] }
+			}).bind();
+			drawArrays(TRIANGLES, 3);
+		}
+	});
+	Pipeline::unbind();
+
+	destroyBenchmarkWindow(window);
+	return EXIT_SUCCESS;
+}
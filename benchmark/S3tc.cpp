@@ -0,0 +1,101 @@
+// Throughput and quality of the S3TC encoder: MPix/s on one core, on a ThreadPool in total and per core, PSNR of the driver's decode against the input.
+// The image is example/res/colorful.png or the path given, tiled up to 2048×2048. Opaque images get a radial alpha ramp so DXT3/5 have something to encode.
+
+#include "Window.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "example/thirdparty/stb_image.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace gl;
+
+constexpr int kSize = 2048;
+
+// Peak signal to noise ratio in dB over the given channels
+static double psnr(std::vector<uint8_t> const& a, std::vector<uint8_t> const& b, int firstChannel, int channels) {
+	double error = 0;
+	size_t count = 0;
+	for(size_t i = 0; i < a.size(); i += 4) {
+		for(int c = firstChannel; c < firstChannel + channels; c++) {
+			double d = double(a[i + c]) - double(b[i + c]);
+			error += d * d;
+			count++;
+		}
+	}
+	error /= double(count);
+	return error == 0 ? 99.0 : 10 * std::log10(255.0 * 255.0 / error);
+}
+
+int main(int argc, char const* argv[]) {
+	char const* path = argc > 1 ? argv[1] : "example/res/colorful.png";
+
+	int width, height, channels;
+	stbi_uc* pixels = stbi_load(path, &width, &height, &channels, 4);
+	if(!pixels) {
+		std::printf("Failed loading %s\n", path);
+		return EXIT_FAILURE;
+	}
+	std::vector<uint8_t> image(size_t(kSize) * kSize * 4);
+	for(int y = 0; y < kSize; y++) {
+		for(int x = 0; x < kSize; x++) {
+			uint8_t*       dst = &image[(size_t(y) * kSize + x) * 4];
+			uint8_t const* src = &pixels[(size_t(y % height) * width + x % width) * 4];
+			std::copy(src, src + 4, dst);
+			if(channels < 4) {
+				float dx = float(x) / kSize - 0.5f, dy = float(y) / kSize - 0.5f;
+				dst[3] = uint8_t(std::min(1.f, std::sqrt(dx * dx + dy * dy) * 2.f) * 255.f);
+			}
+		}
+	}
+	stbi_image_free(pixels);
+
+	GLFWwindow* window = createBenchmarkWindow("S3tc benchmark");
+	if(!window) return EXIT_FAILURE;
+
+	ThreadPool pool;
+	std::printf("%s, %s tiled to %dx%d, %u threads + the caller\n", (const char*) glGetString(GL_RENDERER), path, kSize, kSize, pool.size());
+	std::printf("%-6s %-5s %12s %12s %12s %9s %9s\n", "format", "mode", "1 core", "pool", "pool / core", "RGB PSNR", "A PSNR");
+	unsigned cores = pool.size() + 1; // The caller works too
+
+	struct { char const* name; CompressedImageFormat format; } formats[] = {
+		{ "DXT1", COMPRESSED_RGB_S3TC_DXT1 },
+		{ "DXT3", COMPRESSED_RGBA_S3TC_DXT3 },
+		{ "DXT5", COMPRESSED_RGBA_S3TC_DXT5 },
+	};
+	using Clock = std::chrono::steady_clock;
+	double megapixels = double(kSize) * kSize / 1e6;
+	for(auto const& f : formats) {
+		for(S3tcQuality quality : { S3TC_FAST, S3TC_HIGH }) {
+			std::vector<uint8_t> blocks(compressedSize(f.format, kSize, kSize));
+
+			auto start = Clock::now();
+			compressS3tc(f.format, kSize, kSize, image.data(), blocks.data(), quality);
+			double single = std::chrono::duration<double>(Clock::now() - start).count();
+
+			start = Clock::now();
+			compressS3tc(f.format, kSize, kSize, image.data(), blocks.data(), quality, &pool);
+			double pooled = std::chrono::duration<double>(Clock::now() - start).count();
+
+			// Decoded by the driver, like it would be when sampling
+			Texture2D texture;
+			texture.texStorage(1, f.format, kSize, kSize);
+			texture.compressedTexImage(0, f.format, kSize, kSize, unsigned(blocks.size()), blocks.data());
+			std::vector<uint8_t> decoded(image.size());
+			glGetTextureImage(texture, 0, GL_RGBA, GL_UNSIGNED_BYTE, GLsizei(decoded.size()), decoded.data());
+
+			char alpha[16] = "-";
+			if(f.format != COMPRESSED_RGB_S3TC_DXT1)
+				std::snprintf(alpha, sizeof(alpha), "%.2f dB", psnr(image, decoded, 3, 1));
+			std::printf("%-6s %-5s %6.1f MPix/s %6.1f MPix/s %6.1f MPix/s %6.2f dB %9s\n", f.name, quality == S3TC_FAST ? "fast" : "high",
+				megapixels / single, megapixels / pooled, megapixels / pooled / cores, psnr(image, decoded, 0, 3), alpha);
+		}
+	}
+
+	destroyBenchmarkWindow(window);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,108 @@
+// Startup cost of building N programs: one after the other through the Program constructor vs. all at once through ProgramQueue.
+// Every run salts the sources, so the driver's own shader cache can't help either path.
+
+#include "Window.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace gl;
+
+static const char* kVertex = R"(#version 450
+out vec2 vUv;
+void main() {
+	vUv = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+	gl_Position = vec4(vUv * 2 - 1, 0, 1);
+}
+)";
+
+// Big enough that compiling it takes a noticeable amount of time
+static const char* kFragment = R"(#version 450
+in vec2 vUv;
+out vec4 outColor;
+uniform sampler2D uTexture;
+uniform vec4 uParams[16];
+
+vec3 shade(vec2 uv, int i) {
+	vec3 color = texture(uTexture, uv * uParams[i].xy).rgb;
+	for(int j = 0; j < ITERATIONS; j++) {
+		uv = fract(uv * 1.7 + uParams[(i + j) & 15].zw);
+		color += sin(vec3(uv, float(j)) * VARIANT) * 0.1;
+	}
+	return color;
+}
+
+void main() {
+	vec3 color = vec3(0);
+	for(int i = 0; i < 16; i++)
+		color += shade(vUv + vec2(i) * 0.01, i) / 16.0;
+	outColor = vec4(color, 1);
+}
+)";
+
+int main(int argc, char const* argv[]) {
+	int count = argc > 1 ? std::atoi(argv[1]) : 200;
+
+	GLFWwindow* window = createBenchmarkWindow("ShaderCompile benchmark");
+	if(!window) return EXIT_FAILURE;
+
+	std::printf("%s, %d programs, parallel compile %s\n", (const char*) glGetString(GL_RENDERER), count,
+		GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile ? "supported" : "not supported");
+
+	unsigned salt = unsigned(std::chrono::steady_clock::now().time_since_epoch().count());
+	auto defines = [&](int pass, int i) {
+		return "// " + std::to_string(salt) + " " + std::to_string(pass) + "\n"
+			"#define VARIANT " + std::to_string(i % 97 + 1) + ".0\n"
+			"#define ITERATIONS " + std::to_string(4 + i % 5) + "\n";
+	};
+
+	using Clock = std::chrono::steady_clock;
+	auto milliseconds = [](Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+	// Serial, what the Program constructor does
+	{
+		auto start = Clock::now();
+		std::vector<Program> programs;
+		programs.reserve(count);
+		for(int i = 0; i < count; i++) {
+			std::string d = defines(0, i);
+			programs.push_back(Program{
+				VertexShader(kVertex, d),
+				FragmentShader(kFragment, d)
+			});
+		}
+		std::printf("%-24s %9.1f ms\n", "Program constructor", milliseconds(Clock::now() - start));
+	}
+
+	// Parallel
+	{
+		auto start = Clock::now();
+		ProgramQueue queue;
+		std::vector<ProgramQueue::Ticket> tickets;
+		tickets.reserve(count);
+		for(int i = 0; i < count; i++) {
+			std::string d = defines(1, i);
+			tickets.push_back(queue.add({ { VERTEX_SHADER, { kVertex } }, { FRAGMENT_SHADER, { kFragment } } }, d));
+		}
+		auto queued = Clock::now();
+
+		size_t polls = 0;
+		while(queue.poll() > 0) polls++; // A real application would draw a loading screen here
+		auto compiled = Clock::now();
+
+		std::vector<Program> programs;
+		programs.reserve(count);
+		for(ProgramQueue::Ticket ticket : tickets)
+			programs.push_back(queue.take(ticket));
+		auto done = Clock::now();
+
+		std::printf("%-24s %9.1f ms (add %.1f ms, waiting %.1f ms over %zu polls, take %.1f ms)\n", "ProgramQueue",
+			milliseconds(done - start), milliseconds(queued - start), milliseconds(compiled - queued), polls, milliseconds(done - compiled));
+	}
+
+	destroyBenchmarkWindow(window);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,144 @@
+// Streaming small uploads that each get used by a draw right away: Buffer::subdata and Buffer::map into one buffer
+// vs. gl::StreamBuffer handing out regions of a persistently mapped ring, fenced once per frame.
+// Prints the CPU time spent submitting a frame and the time until the GPU finished it.
+
+#include "Window.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+using namespace gl;
+
+constexpr int    kUploads     = 256;       // Per frame
+constexpr size_t kUploadBytes = 16 * 1024;
+constexpr int    kFrames      = 100;
+constexpr size_t kAlignment   = 256;       // Covers every SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT
+
+static const char* kVertex = R"(#version 450
+layout(std430, binding = 1) readonly buffer Upload { vec4 values[]; };
+out vec4 vColor;
+void main() {
+	vec2 corner = vec2(gl_VertexID == 1, gl_VertexID == 2) * 0.01;
+	vColor = values[gl_VertexID * 64] + values[values.length() - 1];
+	gl_Position = vec4(corner + values[0].xy, 0, 1);
+}
+)";
+
+static const char* kFragment = R"(#version 450
+in vec4 vColor;
+out vec4 outColor;
+void main() { outColor = vColor; }
+)";
+
+static void fill(void* to, int frame, int upload) {
+	float* values = static_cast<float*>(to);
+	for(size_t i = 0; i < kUploadBytes / sizeof(float); i++)
+		values[i] = float((frame + upload + int(i)) & 0xFF) / 255.f;
+}
+
+// Allocations bigger than the head once the ring wrapped used to wait for more than the whole ring and crash
+static bool checkWrapAround() {
+	StreamBuffer<ARRAY_BUFFER> ring(100);
+	(void) ring.allocate(10);
+	ring.retire();
+	bool ok = true;
+	size_t sizes[] = { 95, 100, 1, 60, 60, 99, 3, 100, 40, 70 };
+	for(size_t i = 0; i < std::size(sizes); i++) {
+		auto region = ring.allocate(sizes[i], i % 2 ? 4 : 1);
+		std::memset(region.data, int(i), sizes[i]);
+		ok = ok && region.offset + region.size <= ring.capacity() && region.offset % (i % 2 ? 4 : 1) == 0 && ring.available() <= ring.capacity();
+		if(i % 3 == 0) ring.retire();
+	}
+	ring.retire();
+	glFinish();
+	std::printf("Wrapping around with allocations bigger than the head: %s\n", ok ? "ok" : "FAILED");
+	return ok;
+}
+
+template<class DrawFrame>
+static void measure(const char* name, GLFWwindow* window, DrawFrame&& drawFrame) {
+	using Clock = std::chrono::steady_clock;
+	double submitMs = 0, frameMs = 0;
+	for(int frame = -10; frame < kFrames; frame++) { // 10 frames warm up
+		auto start = Clock::now();
+		glClear(GL_COLOR_BUFFER_BIT);
+		drawFrame(frame);
+		auto submitted = Clock::now();
+		glFinish();
+		auto finished = Clock::now();
+		glfwSwapBuffers(window);
+
+		if(frame >= 0) {
+			submitMs += std::chrono::duration<double, std::milli>(submitted - start).count();
+			frameMs  += std::chrono::duration<double, std::milli>(finished  - start).count();
+		}
+	}
+	std::printf("%-30s submit %7.3f ms/frame (%6.2f µs/upload), frame %7.3f ms\n",
+		name, submitMs / kFrames, submitMs / kFrames / kUploads * 1e3, frameMs / kFrames);
+}
+
+int main() {
+	GLFWwindow* window = createBenchmarkWindow("StreamBuffer benchmark");
+	if(!window) return EXIT_FAILURE;
+
+	std::printf("%s, %d uploads of %zu KiB per frame\n", (const char*) glGetString(GL_RENDERER), kUploads, kUploadBytes / 1024);
+
+	if(!checkWrapAround()) {
+		destroyBenchmarkWindow(window);
+		return EXIT_FAILURE;
+	}
+
+	VertexArray empty;
+	empty.bind();
+	Program program{ VertexShader(kVertex), FragmentShader(kFragment) };
+	program.use();
+
+	{
+		ShaderStorageBuffer buffer;
+		buffer.storage(STORAGE_DYNAMIC_BIT, kUploadBytes);
+		std::vector<uint8_t> staging(kUploadBytes);
+		measure("Buffer::subdata", window, [&](int frame) {
+			for(int i = 0; i < kUploads; i++) {
+				fill(staging.data(), frame, i);
+				buffer.subdata(0, kUploadBytes, staging.data());
+				buffer.bindBase(1);
+				drawArrays(TRIANGLES, 3);
+			}
+		});
+	}
+
+	{
+		ShaderStorageBuffer buffer;
+		buffer.storage(STORAGE_MAP_WRITE_BIT, kUploadBytes);
+		measure("Buffer::map", window, [&](int frame) {
+			for(int i = 0; i < kUploads; i++) {
+				{
+					auto mapping = buffer.map(0, kUploadBytes, MAP_WRITE_BIT | MAP_INVALIDATE_BUFFER_BIT);
+					fill(mapping.get(), frame, i);
+				}
+				buffer.bindBase(1);
+				drawArrays(TRIANGLES, 3);
+			}
+		});
+	}
+
+	{
+		StreamBuffer<SHADER_STORAGE_BUFFER> stream(3 * kUploads * (kUploadBytes + kAlignment)); // Three frames in flight
+		measure("StreamBuffer", window, [&](int frame) {
+			for(int i = 0; i < kUploads; i++) {
+				auto region = stream.allocate(kUploadBytes, kAlignment);
+				fill(region.data, frame, i);
+				region.bindRange(1, SHADER_STORAGE_BUFFER);
+				drawArrays(TRIANGLES, 3);
+			}
+			stream.retire();
+		});
+	}
+
+	destroyBenchmarkWindow(window);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,143 @@
+// Load time of one texture with all its mip levels: a PNG decoded by stb_image and mipmapped by the driver
+// vs. the same size as BC1 in a KTX2 and a DDS file, mapped and uploaded by LoadCompressedTexture.
+// The files are written to the temp directory first, so all three are read out of the page cache.
+
+#include "Window.hpp"
+
+#include <glpp-io-util.hpp>
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "example/thirdparty/stb_image.h"
+#include "example/thirdparty/stb_image_write.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace gl;
+
+static void append32(std::vector<uint8_t>& file, uint32_t value) { file.insert(file.end(), (uint8_t*) &value, (uint8_t*) &value + 4); }
+static void append64(std::vector<uint8_t>& file, uint64_t value) { file.insert(file.end(), (uint8_t*) &value, (uint8_t*) &value + 8); }
+
+// Flat colored BC1 blocks following the image, so the compressed files look like the PNG from afar
+static std::vector<uint8_t> bc1Level(std::vector<uint8_t> const& rgba, int size, int level) {
+	int levelSize = std::max(size >> level, 1), blocks = (levelSize + 3) / 4;
+	std::vector<uint8_t> result;
+	result.reserve(size_t(blocks) * blocks * 8);
+	for(int y = 0; y < blocks; y++) {
+		for(int x = 0; x < blocks; x++) {
+			uint8_t const* p = &rgba[(size_t(y * 4 << level) * size + (x * 4 << level)) * 4];
+			uint16_t color = uint16_t((p[0] >> 3) << 11 | (p[1] >> 2) << 5 | p[2] >> 3);
+			uint8_t block[8] = { uint8_t(color), uint8_t(color >> 8), uint8_t(color), uint8_t(color >> 8) };
+			result.insert(result.end(), block, block + 8);
+		}
+	}
+	return result;
+}
+
+static void writeFile(std::string const& path, std::vector<uint8_t> const& data) {
+	std::ofstream(path, std::ios::binary).write((char const*) data.data(), std::streamsize(data.size()));
+}
+
+int main(int argc, char const* argv[]) {
+	int size = argc > 1 ? std::atoi(argv[1]) : 2048;
+	int runs = argc > 2 ? std::atoi(argv[2]) : 10;
+
+	GLFWwindow* window = createBenchmarkWindow("TextureLoad benchmark");
+	if(!window) return EXIT_FAILURE;
+
+	int levels = 1;
+	while(size >> levels) levels++;
+	std::printf("%s, %dx%d, %d levels, %d runs\n", (const char*) glGetString(GL_RENDERER), size, size, levels, runs);
+
+	// Smooth gradients with some noise, compresses about as well as a photo
+	std::vector<uint8_t> rgba(size_t(size) * size * 4);
+	uint32_t noise = 1;
+	for(int y = 0; y < size; y++) {
+		for(int x = 0; x < size; x++) {
+			noise = noise * 1664525u + 1013904223u;
+			uint8_t* p = &rgba[(size_t(y) * size + x) * 4];
+			p[0] = uint8_t(x * 255 / size + (noise >> 28));
+			p[1] = uint8_t(y * 255 / size + (noise >> 24 & 15));
+			p[2] = uint8_t((x ^ y) & 255);
+			p[3] = 255;
+		}
+	}
+
+	std::string directory = std::filesystem::temp_directory_path().string();
+	std::string png = directory + "/glpp-texture-load.png", ktx2 = directory + "/glpp-texture-load.ktx2", dds = directory + "/glpp-texture-load.dds";
+	stbi_write_png(png.c_str(), size, size, 4, rgba.data(), size * 4);
+
+	std::vector<std::vector<uint8_t>> blocks;
+	for(int level = 0; level < levels; level++)
+		blocks.push_back(bc1Level(rgba, size, level));
+	{
+		static uint8_t const identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+		std::vector<uint8_t> file(identifier, identifier + 12);
+		for(uint32_t value : { 133u /* BC1_RGBA_UNORM */, 1u, uint32_t(size), uint32_t(size), 0u, 0u, 1u, uint32_t(levels), 0u, 0u, 0u, 0u, 0u })
+			append32(file, value);
+		append64(file, 0);
+		append64(file, 0);
+		uint64_t offset = file.size() + levels * 24;
+		for(auto const& level : blocks) {
+			append64(file, offset);
+			append64(file, level.size());
+			append64(file, level.size());
+			offset += level.size();
+		}
+		for(auto const& level : blocks)
+			file.insert(file.end(), level.begin(), level.end());
+		writeFile(ktx2, file);
+	}
+	{
+		std::vector<uint8_t> file = { 'D', 'D', 'S', ' ' };
+		for(uint32_t value : { 124u, 0x21007u, uint32_t(size), uint32_t(size), uint32_t(blocks[0].size()), 0u, uint32_t(levels) })
+			append32(file, value);
+		file.resize(file.size() + 11 * 4);
+		append32(file, 32);
+		append32(file, 0x4); // DDPF_FOURCC
+		file.insert(file.end(), { 'D', 'X', 'T', '1' });
+		file.resize(128);
+		std::memcpy(&file[108], "\x08\x10\x40\x00", 4); // DDSCAPS_TEXTURE | DDSCAPS_MIPMAP | DDSCAPS_COMPLEX
+		for(auto const& level : blocks)
+			file.insert(file.end(), level.begin(), level.end());
+		writeFile(dds, file);
+	}
+
+	using Clock = std::chrono::steady_clock;
+	auto measure = [&](char const* name, auto&& load) {
+		glFinish();
+		auto start = Clock::now();
+		for(int i = 0; i < runs; i++) {
+			Texture2D texture = load();
+			glFinish(); // Includes the driver's side of the upload
+		}
+		std::printf("%-32s %9.2f ms per texture\n", name, std::chrono::duration<double, std::milli>(Clock::now() - start).count() / runs);
+	};
+
+	measure("PNG + glGenerateMipmap", [&] {
+		int width, height, channels;
+		stbi_uc* pixels = stbi_load(png.c_str(), &width, &height, &channels, 4);
+		Texture2D texture;
+		texture.texStorage(levels, RGBA8, width, height);
+		texture.texSubimage(0, 0, 0, width, height, RGBA, UNSIGNED_BYTE, pixels);
+		texture.generateMipmaps();
+		stbi_image_free(pixels);
+		return texture;
+	});
+	measure("KTX2 BC1, mapped", [&] { return LoadCompressedTexture(ktx2); });
+	measure("DDS BC1, mapped", [&] { return LoadCompressedTexture(dds); });
+
+	std::filesystem::remove(png);
+	std::filesystem::remove(ktx2);
+	std::filesystem::remove(dds);
+
+	destroyBenchmarkWindow(window);
+	return EXIT_SUCCESS;
+}
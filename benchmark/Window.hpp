@@ -0,0 +1,31 @@
+#pragma once
+
+#include <glpp.hpp>
+#include <GLFW/glfw3.h>
+
+#include <cstdio>
+
+// A hidden window with a GL 4.5 core context made current, nullptr on failure
+inline GLFWwindow* createBenchmarkWindow(const char* title) {
+	glfwInit();
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	GLFWwindow* window = glfwCreateWindow(512, 512, title, nullptr, nullptr);
+	if(!window) {
+		std::puts("Failed creating a GL 4.5 window");
+		glfwTerminate();
+		return nullptr;
+	}
+	glfwMakeContextCurrent(window);
+	glfwSwapInterval(0);
+	glewExperimental = true;
+	glewInit();
+	return window;
+}
+
+inline void destroyBenchmarkWindow(GLFWwindow* window) {
+	glfwDestroyWindow(window);
+	glfwTerminate();
+}
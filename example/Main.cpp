@@ -23,6 +23,10 @@ void mainLoop(GLFWwindow* window) {
 	};
 	// glReleaseShaderCompiler();
 
+	auto uTime           = shader3d.uniformHandle<float>("uTime"_u);
+	auto uViewProjection = shader3d.uniformHandle<glm::mat4>("uViewProjection"_u);
+	auto uModel          = shader3d.uniformHandle<glm::mat4>("uModel"_u);
+
 	Mesh meshdata;
 	meshdata.load("example/res/suzanne_flat.obj");
 
@@ -65,9 +69,9 @@ void mainLoop(GLFWwindow* window) {
 		shader3d.use();
 		mesh.bind();
 
-		shader3d.uniform("uTime", now());
-		shader3d.uniform("uViewProjection", glm::perspectiveFov(glm::radians(60.f), (float) windowWidth, (float) windowHeight, .1f, 100.f));
-		shader3d.uniform("uModel", glm::translate(glm::vec3(0, 0, -3)) * glm::rotate((float)now(), glm::vec3(0, 1, 0)));
+		uTime           = now();
+		uViewProjection = glm::perspectiveFov(glm::radians(60.f), (float) windowWidth, (float) windowHeight, .1f, 100.f);
+		uModel          = glm::translate(glm::vec3(0, 0, -3)) * glm::rotate((float)now(), glm::vec3(0, 1, 0));
 
 		drawElements(TRIANGLES, UINT16, meshdata.indices.size());
 
@@ -1,9 +1,17 @@
 #pragma once
 
+#include "./glpp/FrameCapture.hpp"
+#include "./glpp/MappedFile.hpp"
 #include "./glpp/Shader.hpp"
 #include "./glpp/Program.hpp"
+#include "./glpp/Texture.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
 
 namespace gl {
 
@@ -19,7 +27,14 @@ inline std::string LoadFile(std::string path) {
 	return result;
 }
 
+inline bool IsSpirvPath(std::string_view path) {
+	return path.ends_with(".spv");
+}
+
+/// Looks at the extension, ".spv" is skipped (e.g. "lit.frag.spv")
 inline gl::ShaderType GuessShaderType(std::string_view path) {
+	if(IsSpirvPath(path))
+		path.remove_suffix(4);
 	if(path.ends_with(".fs") || path.ends_with(".frag") || path.ends_with(".frag.glsl"))
 		return gl::FRAGMENT_SHADER;
 	if(path.ends_with(".vs") || path.ends_with(".vert") || path.ends_with(".vert.glsl"))
@@ -35,13 +50,290 @@ inline gl::ShaderType GuessShaderType(std::string_view path) {
 	throw std::runtime_error("Couldn't guess shader type based on file path for " + std::string(path));
 }
 
+/// Maps the file instead of reading it, the driver copies the module straight out of the page cache
+inline gl::Shader LoadSpirvShader(std::string path, gl::ShaderType type, std::initializer_list<gl::SpecializationConstant> constants = {}, char const* entryPoint = "main") {
+	gl::detail::MappedFile file(path.c_str());
+	if(!file.data())
+		throw std::runtime_error("Failed opening file " + path);
+	return gl::Shader(type, file.data(), int(file.size()), entryPoint, constants);
+}
+
+inline gl::Shader LoadSpirvShader(std::string path, std::initializer_list<gl::SpecializationConstant> constants = {}, char const* entryPoint = "main") {
+	return LoadSpirvShader(path, GuessShaderType(path), constants, entryPoint);
+}
+
+/// GLSL source, or SPIR-V if the path ends with ".spv"
 inline gl::Shader LoadShader(std::string path, gl::ShaderType type) {
+	if(IsSpirvPath(path))
+		return LoadSpirvShader(path, type);
 	return gl::Shader(type, LoadFile(path));
 }
 
-// TODO: SpirV support
 inline gl::Shader LoadShader(std::string path) {
 	return LoadShader(path, GuessShaderType(path));
 }
 
+/// A block compressed image inside a KTX2 or DDS file, pointing into the file's memory
+struct CompressedImage {
+	/// Blocks of one level for consecutive layer-faces
+	struct Region {
+		GLsizei        level;
+		GLsizei        layer;  // First layer-face, layer * 6 + face for cubemaps like GL counts them
+		GLsizei        layers; // Number of layer-faces
+		uint8_t const* data;
+		size_t         size;
+	};
+
+	CompressedImageFormat format  = COMPRESSED_RGBA_S3TC_DXT1;
+	GLsizei               width   = 0;
+	GLsizei               height  = 0;
+	GLsizei               levels  = 1;
+	GLsizei               layers  = 0; // 0 if it isn't an array
+	bool                  cubemap = false;
+	std::vector<Region>   regions;
+
+	GLsizei layerFaces() const noexcept { return std::max(layers, 1) * (cubemap ? 6 : 1); }
+	GLsizei levelWidth (GLsizei level) const noexcept { return std::max(width  >> level, 1); }
+	GLsizei levelHeight(GLsizei level) const noexcept { return std::max(height >> level, 1); }
+	/// Bytes of one layer-face
+	size_t  levelSize  (GLsizei level) const noexcept { return size_t((levelWidth(level) + 3) / 4) * size_t((levelHeight(level) + 3) / 4) * blockSize(format); }
+};
+
+namespace detail {
+
+template<class T>
+T ReadLittleEndian(uint8_t const* data) noexcept {
+	T result;
+	std::memcpy(&result, data, sizeof(T)); // Both formats are little endian, like everything that runs GL 4.5
+	return result;
+}
+
+inline void ValidateCompressedImage(CompressedImage const& image, std::string const& name) {
+	if(image.width <= 0 || image.height <= 0)
+		throw std::runtime_error(name + ": only 2D images are supported");
+	GLsizei maxLevels = 1;
+	while(std::max(image.width, image.height) >> maxLevels) maxLevels++;
+	if(image.levels > maxLevels)
+		throw std::runtime_error(name + ": more mip levels than the size allows");
+}
+
+} // namespace detail
+
+/// Parses a KTX2 file with BC1-7 contents, without supercompression. Throws if the header doesn't add up with the file's size.
+inline CompressedImage ParseKtx2(uint8_t const* data, size_t size, std::string const& name = "KTX2 file") {
+	static uint8_t const kIdentifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+	constexpr size_t kHeaderSize = 80, kLevelIndexEntrySize = 24;
+	if(size < kHeaderSize || std::memcmp(data, kIdentifier, sizeof(kIdentifier)) != 0)
+		throw std::runtime_error(name + ": not a KTX2 file");
+
+	CompressedImage image;
+	uint32_t vkFormat = detail::ReadLittleEndian<uint32_t>(data + 12);
+	switch(vkFormat) {
+	case 131: image.format = COMPRESSED_RGB_S3TC_DXT1; break;
+	case 132: image.format = COMPRESSED_SRGB_S3TC_DXT1; break;
+	case 133: image.format = COMPRESSED_RGBA_S3TC_DXT1; break;
+	case 134: image.format = COMPRESSED_SRGB_ALPHA_S3TC_DXT1; break;
+	case 135: image.format = COMPRESSED_RGBA_S3TC_DXT3; break;
+	case 136: image.format = COMPRESSED_SRGB_ALPHA_S3TC_DXT3; break;
+	case 137: image.format = COMPRESSED_RGBA_S3TC_DXT5; break;
+	case 138: image.format = COMPRESSED_SRGB_ALPHA_S3TC_DXT5; break;
+	case 139: image.format = COMPRESSED_RED_RGTC1; break;
+	case 140: image.format = COMPRESSED_SIGNED_RED_RGTC1; break;
+	case 141: image.format = COMPRESSED_RG_RGTC2; break;
+	case 142: image.format = COMPRESSED_SIGNED_RG_RGTC2; break;
+	case 143: image.format = COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT; break;
+	case 144: image.format = COMPRESSED_RGB_BPTC_SIGNED_FLOAT; break;
+	case 145: image.format = COMPRESSED_RGBA_BPTC_UNORM; break;
+	case 146: image.format = COMPRESSED_SRGB_ALPHA_BPTC_UNORM; break;
+	default: throw std::runtime_error(name + ": unsupported vkFormat " + std::to_string(vkFormat) + ", only BC1-7 are");
+	}
+
+	uint32_t width  = detail::ReadLittleEndian<uint32_t>(data + 20);
+	uint32_t height = detail::ReadLittleEndian<uint32_t>(data + 24);
+	uint32_t depth  = detail::ReadLittleEndian<uint32_t>(data + 28);
+	uint32_t layers = detail::ReadLittleEndian<uint32_t>(data + 32);
+	uint32_t faces  = detail::ReadLittleEndian<uint32_t>(data + 36);
+	uint32_t levels = detail::ReadLittleEndian<uint32_t>(data + 40);
+	uint32_t supercompression = detail::ReadLittleEndian<uint32_t>(data + 44);
+	if(depth != 0 || width > 1u << 16 || height > 1u << 16 || layers > 1u << 16)
+		throw std::runtime_error(name + ": only 2D images are supported");
+	if(faces != 1 && faces != 6)
+		throw std::runtime_error(name + ": faceCount has to be 1 or 6");
+	if(supercompression != 0)
+		throw std::runtime_error(name + ": supercompression is not supported");
+
+	image.width   = GLsizei(width);
+	image.height  = GLsizei(height);
+	image.levels  = GLsizei(std::max(levels, 1u)); // 0 asks the loader to generate them, which compressed formats can't
+	image.layers  = GLsizei(layers);
+	image.cubemap = faces == 6;
+	detail::ValidateCompressedImage(image, name);
+
+	if(size < kHeaderSize + image.levels * kLevelIndexEntrySize)
+		throw std::runtime_error(name + ": truncated level index");
+	for(GLsizei level = 0; level < image.levels; level++) {
+		uint8_t const* entry  = data + kHeaderSize + level * kLevelIndexEntrySize;
+		uint64_t       offset = detail::ReadLittleEndian<uint64_t>(entry);
+		uint64_t       length = detail::ReadLittleEndian<uint64_t>(entry + 8);
+		if(length != image.levelSize(level) * image.layerFaces())
+			throw std::runtime_error(name + ": level " + std::to_string(level) + " has the wrong size");
+		if(offset > size || length > size - offset)
+			throw std::runtime_error(name + ": level " + std::to_string(level) + " is outside of the file");
+		// Layers, then faces within each layer: the order of GL's layer-faces
+		image.regions.push_back({ level, 0, image.layerFaces(), data + offset, size_t(length) });
+	}
+	return image;
+}
+
+/// Parses a DDS file with DXT1-5, ATI1/2 (BC4/5) or DX10 BC1-7 contents. Throws if the header doesn't add up with the file's size.
+inline CompressedImage ParseDds(uint8_t const* data, size_t size, std::string const& name = "DDS file") {
+	constexpr size_t kHeaderSize = 128, kDx10HeaderSize = 20;
+	constexpr uint32_t kMipMapCount = 0x20000, kFourCC = 0x4, kCubemap = 0x200, kAllFaces = 0xFC00, kVolume = 0x200000;
+	if(size < kHeaderSize || std::memcmp(data, "DDS ", 4) != 0 || detail::ReadLittleEndian<uint32_t>(data + 4) != 124)
+		throw std::runtime_error(name + ": not a DDS file");
+
+	auto fourCC = [](char const* code) { return uint32_t(code[0]) | uint32_t(code[1]) << 8 | uint32_t(code[2]) << 16 | uint32_t(code[3]) << 24; };
+
+	CompressedImage image;
+	uint32_t flags       = detail::ReadLittleEndian<uint32_t>(data + 8);
+	uint32_t height      = detail::ReadLittleEndian<uint32_t>(data + 12);
+	uint32_t width       = detail::ReadLittleEndian<uint32_t>(data + 16);
+	uint32_t levels      = detail::ReadLittleEndian<uint32_t>(data + 28);
+	uint32_t formatFlags = detail::ReadLittleEndian<uint32_t>(data + 80);
+	uint32_t format      = detail::ReadLittleEndian<uint32_t>(data + 84);
+	uint32_t caps2       = detail::ReadLittleEndian<uint32_t>(data + 112);
+	if(!(formatFlags & kFourCC))
+		throw std::runtime_error(name + ": only block compressed contents are supported");
+	if(caps2 & kVolume)
+		throw std::runtime_error(name + ": only 2D images are supported");
+	if(width > 1u << 16 || height > 1u << 16)
+		throw std::runtime_error(name + ": too big");
+
+	size_t offset = kHeaderSize;
+	uint32_t layers = 1;
+	image.cubemap = caps2 & kCubemap;
+	if(image.cubemap && (caps2 & kAllFaces) != kAllFaces)
+		throw std::runtime_error(name + ": cubemaps need all 6 faces");
+
+	if     (format == fourCC("DXT1")) image.format = COMPRESSED_RGBA_S3TC_DXT1;
+	else if(format == fourCC("DXT2") || format == fourCC("DXT3")) image.format = COMPRESSED_RGBA_S3TC_DXT3;
+	else if(format == fourCC("DXT4") || format == fourCC("DXT5")) image.format = COMPRESSED_RGBA_S3TC_DXT5;
+	else if(format == fourCC("ATI1") || format == fourCC("BC4U")) image.format = COMPRESSED_RED_RGTC1;
+	else if(format == fourCC("BC4S")) image.format = COMPRESSED_SIGNED_RED_RGTC1;
+	else if(format == fourCC("ATI2") || format == fourCC("BC5U")) image.format = COMPRESSED_RG_RGTC2;
+	else if(format == fourCC("BC5S")) image.format = COMPRESSED_SIGNED_RG_RGTC2;
+	else if(format == fourCC("DX10")) {
+		if(size < kHeaderSize + kDx10HeaderSize)
+			throw std::runtime_error(name + ": truncated DX10 header");
+		uint32_t dxgiFormat = detail::ReadLittleEndian<uint32_t>(data + 128);
+		uint32_t dimension  = detail::ReadLittleEndian<uint32_t>(data + 132);
+		uint32_t misc       = detail::ReadLittleEndian<uint32_t>(data + 136);
+		layers              = detail::ReadLittleEndian<uint32_t>(data + 140);
+		switch(dxgiFormat) {
+		case 71: image.format = COMPRESSED_RGBA_S3TC_DXT1; break;
+		case 72: image.format = COMPRESSED_SRGB_ALPHA_S3TC_DXT1; break;
+		case 74: image.format = COMPRESSED_RGBA_S3TC_DXT3; break;
+		case 75: image.format = COMPRESSED_SRGB_ALPHA_S3TC_DXT3; break;
+		case 77: image.format = COMPRESSED_RGBA_S3TC_DXT5; break;
+		case 78: image.format = COMPRESSED_SRGB_ALPHA_S3TC_DXT5; break;
+		case 80: image.format = COMPRESSED_RED_RGTC1; break;
+		case 81: image.format = COMPRESSED_SIGNED_RED_RGTC1; break;
+		case 83: image.format = COMPRESSED_RG_RGTC2; break;
+		case 84: image.format = COMPRESSED_SIGNED_RG_RGTC2; break;
+		case 95: image.format = COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT; break;
+		case 96: image.format = COMPRESSED_RGB_BPTC_SIGNED_FLOAT; break;
+		case 98: image.format = COMPRESSED_RGBA_BPTC_UNORM; break;
+		case 99: image.format = COMPRESSED_SRGB_ALPHA_BPTC_UNORM; break;
+		default: throw std::runtime_error(name + ": unsupported DXGI format " + std::to_string(dxgiFormat) + ", only BC1-7 are");
+		}
+		if(dimension != 3) // D3D10_RESOURCE_DIMENSION_TEXTURE2D
+			throw std::runtime_error(name + ": only 2D images are supported");
+		if(layers == 0 || layers > 1u << 16)
+			throw std::runtime_error(name + ": invalid arraySize");
+		image.cubemap = misc & 0x4; // D3D10_RESOURCE_MISC_TEXTURECUBE
+		image.layers  = layers > 1 ? GLsizei(layers) : 0;
+		offset += kDx10HeaderSize;
+	}
+	else throw std::runtime_error(name + ": unsupported FourCC");
+
+	image.width  = GLsizei(width);
+	image.height = GLsizei(height);
+	image.levels = flags & kMipMapCount ? GLsizei(std::max(levels, 1u)) : 1;
+	detail::ValidateCompressedImage(image, name);
+
+	// All levels of the first layer-face, then all levels of the next one
+	for(GLsizei layer = 0; layer < image.layerFaces(); layer++) {
+		for(GLsizei level = 0; level < image.levels; level++) {
+			size_t length = image.levelSize(level);
+			if(length > size - offset)
+				throw std::runtime_error(name + ": truncated image data");
+			image.regions.push_back({ level, layer, 1, data + offset, length });
+			offset += length;
+		}
+	}
+	return image;
+}
+
+/// KTX2 or DDS, depending on the magic number
+inline CompressedImage ParseCompressedImage(uint8_t const* data, size_t size, std::string const& name) {
+	if(size >= 4 && std::memcmp(data, "DDS ", 4) == 0)
+		return ParseDds(data, size, name);
+	return ParseKtx2(data, size, name);
+}
+
+/// Allocates immutable storage for all levels and uploads the blocks with glCompressedTextureSubImage*, straight from wherever `image` points.
+/// No PIXEL_UNPACK_BUFFER may be bound. Throws if the image's shape doesn't fit the texture type.
+template<TextureType type>
+void UploadCompressedImage(BasicTextureView<type> texture, CompressedImage const& image) {
+	static_assert(type == TEXTURE_2D || type == TEXTURE_2D_ARRAY || type == TEXTURE_CUBE_MAP || type == TEXTURE_CUBE_MAP_ARRAY,
+		"Compressed images are 2D, 2D arrays, cubemaps or cubemap arrays");
+	constexpr bool cubemap = type == TEXTURE_CUBE_MAP || type == TEXTURE_CUBE_MAP_ARRAY;
+	constexpr bool array   = type == TEXTURE_2D_ARRAY || type == TEXTURE_CUBE_MAP_ARRAY;
+	// A single image also fits an array with one layer
+	if(image.cubemap != cubemap || (image.layers > 1 && !array))
+		throw std::runtime_error("The compressed image's shape doesn't fit the texture type");
+
+	if constexpr(array)
+		texture.texStorage(image.levels, image.format, image.width, image.height, image.layerFaces());
+	else
+		texture.texStorage(image.levels, image.format, image.width, image.height);
+
+	for(CompressedImage::Region const& region : image.regions) {
+		if constexpr(type == TEXTURE_2D)
+			texture.compressedTexSubimage(region.level, 0, 0, image.levelWidth(region.level), image.levelHeight(region.level), image.format, unsigned(region.size), region.data);
+		else
+			texture.compressedTexSubimage(region.level, 0, 0, region.layer, image.levelWidth(region.level), image.levelHeight(region.level), region.layers, image.format, unsigned(region.size), region.data);
+	}
+}
+
+/// Maps a KTX2 or DDS file and uploads it without copying it, the driver reads the blocks straight out of the page cache:
+///
+///     gl::Texture2D     albedo = gl::LoadCompressedTexture("albedo.ktx2");
+///     gl::TextureCubemap sky   = gl::LoadCompressedTexture<gl::TEXTURE_CUBE_MAP>("sky.dds");
+template<TextureType type = TEXTURE_2D>
+BasicTexture<type> LoadCompressedTexture(std::string path) {
+	gl::detail::MappedFile file(path.c_str());
+	if(!file.data())
+		throw std::runtime_error("Failed opening file " + path);
+
+	BasicTexture<type> texture;
+	UploadCompressedImage<type>(texture, ParseCompressedImage(file.data(), file.size(), path));
+	return texture;
+}
+
+#ifdef INCLUDE_STB_IMAGE_WRITE_H
+
+/// Captures a region of a framebuffer to a PNG file without waiting for the GPU, stb_image_write encodes it on one of the capture's workers.
+/// Only there if stb_image_write.h is included before this header. False if the frame was dropped.
+inline bool CapturePng(FrameCapture& capture, FramebufferView framebuffer, GLint x, GLint y, GLsizei width, GLsizei height, std::string path) {
+	return capture.capture(framebuffer, x, y, width, height, RGB, UNSIGNED_BYTE, [path = std::move(path)](FrameCapture::Frame const& frame) {
+		// Starting at the last row with a negative stride flips GL's bottom-up rows
+		int stride = frame.width * 3;
+		auto const* top = static_cast<uint8_t const*>(frame.pixels) + size_t(frame.height - 1) * stride;
+		stbi_write_png(path.c_str(), frame.width, frame.height, 3, top, -stride);
+	});
+}
+
+#endif // INCLUDE_STB_IMAGE_WRITE_H
+
 } // namespace gl
@@ -3,18 +3,36 @@
 
 #include <GL/glew.h>
 
+#include "glpp/AsyncReadback.hpp"
 #include "glpp/Buffer.hpp"
+#include "glpp/BufferHeap.hpp"
 #include "glpp/Debug.hpp"
+#include "glpp/DrawConstants.hpp"
 #include "glpp/Drawing.hpp"
 #include "glpp/Enums.hpp"
+#include "glpp/FrameCapture.hpp"
 #include "glpp/Framebuffer.hpp"
+#include "glpp/Hash.hpp"
+#include "glpp/Layout.hpp"
+#include "glpp/MappedFile.hpp"
+#include "glpp/MipChain.hpp"
 #include "glpp/Pipeline.hpp"
 #include "glpp/Program.hpp"
+#include "glpp/ProgramCache.hpp"
+#include "glpp/ProgramQueue.hpp"
+#include "glpp/ProgramReflection.hpp"
+#include "glpp/S3tc.hpp"
 #include "glpp/Sampler.hpp"
 #include "glpp/Shader.hpp"
+#include "glpp/ShaderVariantSet.hpp"
 #include "glpp/State.hpp"
 #include "glpp/Sync.hpp"
 #include "glpp/Texture.hpp"
+#include "glpp/TextureAtlas.hpp"
+#include "glpp/TextureStreamer.hpp"
+#include "glpp/ThreadPool.hpp"
+#include "glpp/Uniform.hpp"
+#include "glpp/UploadBatch.hpp"
 #include "glpp/VertexArray.hpp"
 
 
@@ -22,14 +40,32 @@
 
 	#define GLPP_INLINE
 	#define GLPP_DECL inline
+	#include "glpp/AsyncReadback.cpp"
 	#include "glpp/Buffer.cpp"
+	#include "glpp/BufferHeap.cpp"
 	#include "glpp/Debug.cpp"
+	#include "glpp/DrawConstants.cpp"
 	#include "glpp/Enums.cpp"
+	#include "glpp/FrameCapture.cpp"
 	#include "glpp/Framebuffer.cpp"
+	#include "glpp/Layout.cpp"
+	#include "glpp/MappedFile.cpp"
+	#include "glpp/MipChain.cpp"
+	#include "glpp/Pipeline.cpp"
 	#include "glpp/Program.cpp"
+	#include "glpp/ProgramCache.cpp"
+	#include "glpp/ProgramQueue.cpp"
+	#include "glpp/ProgramReflection.cpp"
+	#include "glpp/S3tc.cpp"
 	#include "glpp/Sampler.cpp"
 	#include "glpp/Shader.cpp"
+	#include "glpp/ShaderVariantSet.cpp"
 	#include "glpp/Texture.cpp"
+	#include "glpp/TextureAtlas.cpp"
+	#include "glpp/TextureStreamer.cpp"
+	#include "glpp/ThreadPool.cpp"
+	#include "glpp/Uniform.cpp"
+	#include "glpp/UploadBatch.cpp"
 	#include "glpp/VertexArray.cpp"
 
 #endif // (GLPP_NO_INLINE)
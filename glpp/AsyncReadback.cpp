@@ -0,0 +1,149 @@
+#include "AsyncReadback.hpp"
+
+#include <cassert>
+#include <utility>
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+// -- Handle -----------------------------------------------------
+
+GLPP_DECL
+AsyncReadback::Handle::Handle(Handle&& other) noexcept :
+	mOwner(std::exchange(other.mOwner, nullptr)),
+	mSequence(other.mSequence),
+	mSync(std::move(other.mSync)),
+	mData(std::exchange(other.mData, nullptr)),
+	mSize(std::exchange(other.mSize, 0)),
+	mFallback(std::move(other.mFallback))
+{}
+
+GLPP_DECL
+auto AsyncReadback::Handle::operator=(Handle&& other) noexcept
+	-> Handle&
+{
+	release();
+	mOwner    = std::exchange(other.mOwner, nullptr);
+	mSequence = other.mSequence;
+	mSync     = std::move(other.mSync);
+	mData     = std::exchange(other.mData, nullptr);
+	mSize     = std::exchange(other.mSize, 0);
+	mFallback = std::move(other.mFallback);
+	return *this;
+}
+
+GLPP_DECL
+bool AsyncReadback::Handle::ready() const noexcept {
+	// A zero timeout wait also flushes, so the fence is guaranteed to signal eventually
+	return !mSync || mSync.waitClient(0);
+}
+
+GLPP_DECL
+void AsyncReadback::Handle::wait() const noexcept {
+	if(mSync)
+		(void) mSync.waitClient();
+}
+
+GLPP_DECL
+void AsyncReadback::Handle::release() noexcept {
+	if(mOwner) {
+		std::exchange(mOwner, nullptr)->release(mSequence);
+	}
+	mSync.reset();
+	mFallback.reset();
+	mData = nullptr;
+	mSize = 0;
+}
+
+// -- AsyncReadback ----------------------------------------------
+
+GLPP_DECL
+AsyncReadback::AsyncReadback(std::nullptr_t) noexcept :
+	mBuffer(nullptr)
+{}
+
+GLPP_DECL
+AsyncReadback::AsyncReadback(size_t capacity) noexcept :
+	AsyncReadback(nullptr)
+{
+	init(capacity);
+}
+
+GLPP_DECL
+AsyncReadback::~AsyncReadback() noexcept {
+	destroy();
+}
+
+GLPP_DECL
+void AsyncReadback::init(size_t capacity) noexcept {
+	destroy();
+
+	mBuffer.init();
+	mBuffer.storage(STORAGE_MAP_READ_BIT | STORAGE_MAP_PERSISTENT_BIT | STORAGE_MAP_COHERENT_BIT, capacity);
+	mMapping  = mBuffer.map(0, capacity, MAP_READ_BIT | MAP_PERSISTENT_BIT | MAP_COHERENT_BIT);
+	mCapacity = capacity;
+}
+
+GLPP_DECL
+void AsyncReadback::destroy() noexcept {
+	assert(mInFlight == 0 && "Destroying an AsyncReadback with live handles");
+	mMapping.reset();
+	mBuffer.destroy();
+	mCapacity = mHead = mInFlight = 0;
+	mFirstSequence += mSlots.size();
+	mSlots.clear();
+}
+
+GLPP_DECL
+auto AsyncReadback::read(unsigned buffer, size_t offset, size_t size) noexcept
+	-> Handle
+{
+	Handle result;
+	result.mSize = size;
+
+	if(mSlots.empty())
+		mHead = 0; // Nothing in flight, start over to avoid wrapping
+
+	size_t ringOffset = 0, needed = 0;
+	if(size <= mCapacity)
+		detail::ringPlacement(mHead, mCapacity, size, 16, ringOffset, needed);
+
+	if(size > mCapacity || needed > mCapacity - mInFlight) {
+		// Ring is full of data nobody released yet
+		mFallbacks++;
+		result.mFallback.reset(new uint8_t[size]);
+		glGetNamedBufferSubData(buffer, offset, size, result.mFallback.get());
+		result.mData = result.mFallback.get();
+		return result;
+	}
+
+	glCopyNamedBufferSubData(buffer, mBuffer, offset, ringOffset, size);
+
+	mHead      = ringOffset + size;
+	mInFlight += needed;
+	mSlots.push_back({ needed, false });
+
+	result.mOwner    = this;
+	result.mSequence = mFirstSequence + mSlots.size() - 1;
+	result.mSync     = fence();
+	result.mData     = static_cast<uint8_t const*>(mMapping.get()) + ringOffset;
+	return result;
+}
+
+GLPP_DECL
+void AsyncReadback::release(uint64_t sequence) noexcept {
+	assert(sequence >= mFirstSequence && sequence - mFirstSequence < mSlots.size());
+	mSlots[sequence - mFirstSequence].released = true;
+
+	// Space can only be reused in ring order
+	while(!mSlots.empty() && mSlots.front().released) {
+		mInFlight -= mSlots.front().bytes;
+		mSlots.pop_front();
+		mFirstSequence++;
+	}
+}
+
+} // namespace gl
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Buffer.hpp"
+#include "Sync.hpp"
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#define GLPP_HAS_SPAN
+#endif
+
+namespace gl {
+
+/// Reads buffer contents back without stalling the pipeline.
+/// read() copies the range into a persistently mapped MAP_READ ring on the GPU and fences it, the returned handle
+/// becomes ready() once the GPU got there. Several readbacks can be in flight at once, their ring space is freed when the handle is destroyed.
+/// If the source was written by shaders, issue glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT) before read().
+/// The AsyncReadback has to outlive all of its handles.
+class AsyncReadback {
+public:
+	class [[nodiscard]] Handle {
+		friend class AsyncReadback;
+
+		AsyncReadback*             mOwner    = nullptr;
+		uint64_t                   mSequence = 0;
+		Sync                       mSync;
+		void const*                mData     = nullptr;
+		size_t                     mSize     = 0;
+		std::unique_ptr<uint8_t[]> mFallback; // Only used if the ring was full
+
+	public:
+		Handle() noexcept = default;
+		~Handle() noexcept { release(); }
+
+		Handle(Handle&& other) noexcept;
+		Handle& operator=(Handle&& other) noexcept;
+		Handle(Handle const& other) = delete;
+		Handle& operator=(Handle const& other) = delete;
+
+		/// Whether the data arrived, never blocks
+		bool ready() const noexcept;
+		/// Blocks until the data arrived
+		void wait() const noexcept;
+
+		/// The data, waits if it isn't ready() yet
+		void const* data() const noexcept { wait(); return mData; }
+		size_t      size() const noexcept { return mSize; }
+		template<class T> T const* as() const noexcept { return static_cast<T const*>(data()); }
+		#ifdef GLPP_HAS_SPAN
+			template<class T = std::byte>
+			std::span<T const> span() const noexcept { return { static_cast<T const*>(data()), mSize / sizeof(T) }; }
+		#endif
+
+		/// Gives the ring space back early
+		void release() noexcept;
+
+		explicit operator bool() const noexcept { return mData != nullptr; }
+	};
+
+	AsyncReadback(std::nullptr_t) noexcept;
+	explicit AsyncReadback(size_t capacity) noexcept;
+	~AsyncReadback() noexcept;
+
+	AsyncReadback(AsyncReadback&& other) noexcept = delete;
+	AsyncReadback& operator=(AsyncReadback&& other) noexcept = delete;
+	AsyncReadback(AsyncReadback const& other) = delete;
+	AsyncReadback& operator=(AsyncReadback const& other) = delete;
+
+	void init(size_t capacity) noexcept;
+	void destroy() noexcept;
+
+	/// Starts copying `size` bytes at `offset` of `buffer`. Falls back to a blocking glGetNamedBufferSubData if the ring is full.
+	Handle read(unsigned buffer, size_t offset, size_t size) noexcept;
+	Handle read(BufferSlice const& slice) noexcept { return read(slice.handle, slice.offset, slice.size); }
+
+	size_t capacity() const noexcept { return mCapacity; }
+	/// Number of readbacks that didn't fit into the ring and had to block
+	size_t fallbacks() const noexcept { return mFallbacks; }
+
+private:
+	struct Slot {
+		size_t bytes; // Including padding and space wasted by wrapping around
+		bool   released;
+	};
+
+	CopyWriteBuffer         mBuffer;
+	detail::BufferMapping<> mMapping;
+	size_t                  mCapacity  = 0;
+	size_t                  mHead      = 0;
+	size_t                  mInFlight  = 0;
+	size_t                  mFallbacks = 0;
+	uint64_t                mFirstSequence = 0; // Sequence number of mSlots.front()
+	std::deque<Slot>        mSlots;
+
+	void release(uint64_t sequence) noexcept;
+};
+
+} // namespace gl
@@ -1,7 +1,9 @@
 #include "Buffer.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstring>
 #include <utility>
 
 #ifndef GLPP_DECL
@@ -47,6 +49,9 @@ void Buffer<type>::init() noexcept {
 	// Let the driver know what kind of buffer we want by binding it once; Will cause bugs on some drivers otherwise
 	this->bind();
 	this->unbind();
+
+	if(!mInfo) mInfo = std::make_unique<detail::BufferInfo>();
+	this->mShadow = mInfo.get();
 }
 template<BufferType type> GLPP_DECL
 void Buffer<type>::destroy() noexcept {
@@ -54,19 +59,25 @@ void Buffer<type>::destroy() noexcept {
 		glDeleteBuffers(1, &this->mHandle);
 		this->mHandle = 0;
 	}
+	if(mInfo) *mInfo = {};
 }
 
 // -- Move -------------------------------------------------------
 
 template<BufferType type> GLPP_DECL
 Buffer<type>::Buffer(Buffer&& other) noexcept :
-	BufferView<type>(std::exchange(other.mHandle, 0))
-{}
+	BufferView<type>(std::exchange(other.mHandle, 0)),
+	mInfo(std::move(other.mInfo))
+{
+	this->mShadow = std::exchange(other.mShadow, nullptr);
+}
 
 template<BufferType type> GLPP_DECL
 Buffer<type>& Buffer<type>::operator=(Buffer&& other) noexcept {
 	destroy();
 	this->mHandle = std::exchange(other.mHandle, 0);
+	this->mShadow = std::exchange(other.mShadow, nullptr);
+	mInfo         = std::move(other.mInfo);
 	return *this;
 }
 
@@ -99,12 +110,24 @@ void BufferView<type>::bindRange(GLuint index, size_t offset_bytes, size_t size_
 template<BufferType type> GLPP_DECL
 void BufferView<type>::storage(BufferStorageBits flags, size_t bytes, void const* data) noexcept {
 	glNamedBufferStorage(mHandle, bytes, data, flags);
+	if(mShadow) {
+		mShadow->size         = bytes;
+		mShadow->storageFlags = flags;
+		mShadow->usage        = DYNAMIC_DRAW; // What the spec says glBufferStorage sets it to
+		mShadow->immutable    = true;
+	}
 }
 
 template<BufferType type> GLPP_DECL
 void BufferView<type>::data(BufferUsage usage, size_t bytes, void const* data) noexcept {
 	// TODO: glBufferData fallback
 	glNamedBufferData(mHandle, bytes, data, usage);
+	if(mShadow) {
+		mShadow->unmapped(); // Reallocating unmaps the buffer
+		mShadow->size         = bytes;
+		mShadow->usage        = usage;
+		mShadow->storageFlags = STORAGE_MAP_READ_BIT | STORAGE_MAP_WRITE_BIT | STORAGE_DYNAMIC_BIT;
+	}
 }
 
 template<BufferType type> GLPP_DECL
@@ -113,6 +136,24 @@ void BufferView<type>::subdata(size_t offset, size_t bytes, void const* data) no
 	glNamedBufferSubData(mHandle, offset, bytes, data);
 }
 
+template<BufferType type> GLPP_DECL
+void BufferView<type>::clear(GLenum internalFormat, GLenum format, BasicType pxtype, void const* data) noexcept {
+	glClearNamedBufferData(mHandle, internalFormat, format, pxtype, data);
+}
+template<BufferType type> GLPP_DECL
+void BufferView<type>::clear(size_t offset, size_t bytes, GLenum internalFormat, GLenum format, BasicType pxtype, void const* data) noexcept {
+	glClearNamedBufferSubData(mHandle, internalFormat, offset, bytes, format, pxtype, data);
+}
+
+template<BufferType type> GLPP_DECL
+void BufferView<type>::scatter(unsigned indices, unsigned values, size_t count, size_t elementSize) noexcept {
+	detail::scatterGather(false, mHandle, values, indices, count, elementSize);
+}
+template<BufferType type> GLPP_DECL
+void BufferView<type>::gather(unsigned indices, unsigned destination, size_t count, size_t elementSize) noexcept {
+	detail::scatterGather(true, destination, mHandle, indices, count, elementSize);
+}
+
 template<BufferType type> GLPP_DECL
 void* BufferView<type>::getPointer() noexcept {
 	// glFlushMappedNamedBufferRange(mHandle, offset, size);
@@ -128,7 +169,7 @@ void BufferView<type>::invalidate() noexcept {
 
 template<BufferType type> GLPP_DECL
 void BufferView<type>::invalidate(size_t offset, size_t length) noexcept {
-	glInvalidateBufferData(mHandle);
+	glInvalidateBufferSubData(mHandle, offset, length);
 }
 
 template<BufferType type> GLPP_DECL
@@ -140,24 +181,41 @@ template<BufferType type> GLPP_DECL
 auto BufferView<type>::map(BufferAccess access) noexcept
 	-> detail::BufferMapping<>
 {
-	return detail::BufferMapping<>(
-		glMapNamedBuffer(mHandle, access),
-		detail::BufferUnmapper { mHandle }
-	);
+	void* pointer = glMapNamedBuffer(mHandle, access);
+	if(mShadow && pointer) {
+		mShadow->mapped      = true;
+		mShadow->access      = access;
+		mShadow->accessFlags =
+			access == READ_ONLY  ? MAP_READ_BIT :
+			access == WRITE_ONLY ? MAP_WRITE_BIT :
+			                       MAP_READ_BIT | MAP_WRITE_BIT;
+		mShadow->mapOffset   = 0;
+		mShadow->mapLength   = mShadow->size;
+	}
+	return detail::BufferMapping<>(pointer, detail::BufferUnmapper { mHandle, mShadow });
 }
 
 template<BufferType type> GLPP_DECL
 auto BufferView<type>::map(size_t offset, size_t length, BufferMappingBits access) noexcept
 	-> detail::BufferMapping<>
 {
-	return detail::BufferMapping<>(
-		glMapNamedBufferRange(mHandle, offset, length, access),
-		detail::BufferUnmapper { mHandle }
-	);
+	void* pointer = glMapNamedBufferRange(mHandle, offset, length, access);
+	if(mShadow && pointer) {
+		mShadow->mapped      = true;
+		mShadow->access      =
+			!(access & MAP_WRITE_BIT) ? READ_ONLY :
+			!(access & MAP_READ_BIT)  ? WRITE_ONLY :
+			                            READ_WRITE;
+		mShadow->accessFlags = access;
+		mShadow->mapOffset   = offset;
+		mShadow->mapLength   = length;
+	}
+	return detail::BufferMapping<>(pointer, detail::BufferUnmapper { mHandle, mShadow });
 }
 
 template<BufferType type> GLPP_DECL
 bool BufferView<type>::unmap() noexcept {
+	if(mShadow) mShadow->unmapped();
 	return glUnmapNamedBuffer(mHandle) == GL_TRUE;
 }
 
@@ -166,64 +224,183 @@ void BufferView<type>::flushMappedRange(size_t offset, size_t length) noexcept {
 	glFlushMappedNamedBufferRange(mHandle, offset, length);
 }
 
+namespace detail {
+
+GLPP_DECL
+GLint64 bufferParameter(unsigned buffer, GLenum parameter) noexcept {
+	GLint64 result = 0;
+	glGetNamedBufferParameteri64v(buffer, parameter, &result);
+	return result;
+}
+
+} // namespace detail
+
+#define GLPP_SHADOWED_BUFFER_GETTER(TYPE, NAME, PARAMETER) \
+	template<BufferType type> GLPP_DECL \
+	TYPE BufferView<type>::NAME() noexcept { \
+		if(!mShadow) \
+			return static_cast<TYPE>(detail::bufferParameter(mHandle, PARAMETER)); \
+		assert(mShadow->NAME == static_cast<TYPE>(detail::bufferParameter(mHandle, PARAMETER)) && "Shadowed buffer state is out of date, was the buffer modified through its raw handle?"); \
+		return mShadow->NAME; \
+	}
+
+GLPP_SHADOWED_BUFFER_GETTER(BufferAccess,      access,       GL_BUFFER_ACCESS)
+GLPP_SHADOWED_BUFFER_GETTER(BufferMappingBits, accessFlags,  GL_BUFFER_ACCESS_FLAGS)
+GLPP_SHADOWED_BUFFER_GETTER(bool,              immutable,    GL_BUFFER_IMMUTABLE_STORAGE)
+GLPP_SHADOWED_BUFFER_GETTER(bool,              mapped,       GL_BUFFER_MAPPED)
+GLPP_SHADOWED_BUFFER_GETTER(size_t,            mapLength,    GL_BUFFER_MAP_LENGTH)
+GLPP_SHADOWED_BUFFER_GETTER(size_t,            mapOffset,    GL_BUFFER_MAP_OFFSET)
+GLPP_SHADOWED_BUFFER_GETTER(size_t,            size,         GL_BUFFER_SIZE)
+GLPP_SHADOWED_BUFFER_GETTER(BufferStorageBits, storageFlags, GL_BUFFER_STORAGE_FLAGS)
+GLPP_SHADOWED_BUFFER_GETTER(BufferUsage,       usage,        GL_BUFFER_USAGE)
+
+#undef GLPP_SHADOWED_BUFFER_GETTER
+
 template<BufferType type> GLPP_DECL
-BufferAccess      BufferView<type>::access() noexcept {
-	GLint result;
-	glGetNamedBufferParameteriv(mHandle, GL_BUFFER_ACCESS, &result);
-	return static_cast<BufferAccess>(result);
+void BufferView<type>::debugLabel(std::string_view name) noexcept {
+	glObjectLabel(GL_BUFFER, mHandle, name.size(), name.data());
 }
+
+/*____   _                                  ____           __   __
+/ ___| | |_  _ __   ___   __ _  _ __ ___  | __ )  _   _  / _| / _|  ___  _ __
+\___ \ | __|| '__| / _ \ / _` || '_ ` _ \ |  _ \ | | | || |_ | |_  / _ \| '__|
+ ___) || |_ | |   |  __/| (_| || | | | | || |_) || |_| ||  _||  _||  __/| |
+|____/  \__||_|    \___| \__,_||_| |_| |_||____/  \__,_||_|  |_|   \___||_|*/
+
 template<BufferType type> GLPP_DECL
-BufferMappingBits BufferView<type>::accessFlags() noexcept {
-	GLbitfield result;
-	glGetNamedBufferParameteriv(mHandle, GL_BUFFER_ACCESS_FLAGS, (GLint*)&result);
-	return static_cast<BufferMappingBits>(result);
+StreamBuffer<type>::StreamBuffer(std::nullptr_t) noexcept :
+	mBuffer(nullptr)
+{}
+
+template<BufferType type> GLPP_DECL
+StreamBuffer<type>::StreamBuffer(size_t capacity, BufferStorageBits extraFlags) noexcept :
+	StreamBuffer(nullptr)
+{
+	init(capacity, extraFlags);
 }
+
 template<BufferType type> GLPP_DECL
-bool              BufferView<type>::immutable() noexcept {
-	GLint result;
-	glGetNamedBufferParameteriv(mHandle, GL_BUFFER_IMMUTABLE_STORAGE, &result);
-	return result == GL_TRUE;
+StreamBuffer<type>::~StreamBuffer() noexcept {
+	destroy();
 }
+
+template<BufferType type> GLPP_DECL
+StreamBuffer<type>::StreamBuffer(StreamBuffer&& other) noexcept :
+	mBuffer(std::move(other.mBuffer)),
+	mMapping(std::move(other.mMapping)),
+	mCapacity(std::exchange(other.mCapacity, 0)),
+	mHead(std::exchange(other.mHead, 0)),
+	mInFlight(std::exchange(other.mInFlight, 0)),
+	mUnfenced(std::exchange(other.mUnfenced, 0)),
+	mFences(std::move(other.mFences))
+{}
+
 template<BufferType type> GLPP_DECL
-bool              BufferView<type>::mapped() noexcept {
-	GLint result;
-	glGetNamedBufferParameteriv(mHandle, GL_BUFFER_MAPPED, &result);
-	return result == GL_TRUE;
+StreamBuffer<type>& StreamBuffer<type>::operator=(StreamBuffer&& other) noexcept {
+	destroy();
+	mBuffer   = std::move(other.mBuffer);
+	mMapping  = std::move(other.mMapping);
+	mCapacity = std::exchange(other.mCapacity, 0);
+	mHead     = std::exchange(other.mHead, 0);
+	mInFlight = std::exchange(other.mInFlight, 0);
+	mUnfenced = std::exchange(other.mUnfenced, 0);
+	mFences   = std::move(other.mFences);
+	return *this;
 }
+
 template<BufferType type> GLPP_DECL
-size_t            BufferView<type>::mapLength() noexcept {
-	GLint64 result;
-	glGetNamedBufferParameteri64v(mHandle, GL_BUFFER_MAP_LENGTH, &result);
-	return result;
+void StreamBuffer<type>::init(size_t capacity, BufferStorageBits extraFlags) noexcept {
+	destroy();
+
+	mBuffer.init();
+	mBuffer.storage(STORAGE_MAP_WRITE_BIT | STORAGE_MAP_PERSISTENT_BIT | STORAGE_MAP_COHERENT_BIT | extraFlags, capacity);
+	mMapping  = mBuffer.map(0, capacity, MAP_WRITE_BIT | MAP_PERSISTENT_BIT | MAP_COHERENT_BIT);
+	mCapacity = capacity;
 }
+
 template<BufferType type> GLPP_DECL
-size_t            BufferView<type>::mapOffset() noexcept {
-	GLint64 result;
-	glGetNamedBufferParameteri64v(mHandle, GL_BUFFER_MAP_OFFSET, &result);
-	return result;
+void StreamBuffer<type>::destroy() noexcept {
+	mFences.clear();
+	mMapping.reset(); // Unmap before the buffer goes away
+	mBuffer.destroy();
+	mCapacity = mHead = mInFlight = mUnfenced = 0;
 }
+
+namespace detail {
+
+GLPP_DECL
+void ringPlacement(size_t head, size_t capacity, size_t bytes, size_t alignment, size_t& offset, size_t& needed) noexcept {
+	offset = (head + alignment - 1) / alignment * alignment;
+	needed = offset + bytes - head;
+	if(offset + bytes > capacity) {
+		// Wrap around, the tail end of the ring is wasted until the GPU passed it
+		offset = 0;
+		needed = capacity - head + bytes;
+	}
+}
+
+} // namespace detail
+
 template<BufferType type> GLPP_DECL
-size_t            BufferView<type>::size() noexcept {
-	GLint64 result;
-	glGetNamedBufferParameteri64v(mHandle, GL_BUFFER_SIZE, &result);
-	return result;
+auto StreamBuffer<type>::allocate(size_t bytes, size_t alignment) noexcept
+	-> Region
+{
+	assert(bytes <= mCapacity && "Allocation doesn't fit into the StreamBuffer");
+	assert(alignment > 0);
+
+	size_t offset, needed;
+	detail::ringPlacement(mHead, mCapacity, bytes, alignment, offset, needed);
+	if(needed > mCapacity) {
+		// Wrapping around would need more than the whole ring, start over at 0 once everything in it is done
+		reclaim(mCapacity);
+		mHead = 0;
+		detail::ringPlacement(mHead, mCapacity, bytes, alignment, offset, needed);
+	}
+
+	reclaim(needed);
+
+	mHead      = offset + bytes;
+	mInFlight += needed;
+	mUnfenced += needed;
+
+	return { { mBuffer, offset, bytes }, static_cast<uint8_t*>(mMapping.get()) + offset };
 }
+
 template<BufferType type> GLPP_DECL
-BufferStorageBits BufferView<type>::storageFlags() noexcept {
-	GLbitfield result;
-	glGetNamedBufferParameteriv(mHandle, GL_BUFFER_ACCESS_FLAGS, reinterpret_cast<GLint*>(&result));
-	return static_cast<BufferStorageBits>(result);
+auto StreamBuffer<type>::push(void const* data, size_t bytes, size_t alignment) noexcept
+	-> Region
+{
+	Region region = allocate(bytes, alignment);
+	std::memcpy(region.data, data, bytes);
+	return region;
 }
+
 template<BufferType type> GLPP_DECL
-BufferUsage       BufferView<type>::usage() noexcept {
-	int result;
-	glGetBufferParameteriv(mHandle, GL_BUFFER_USAGE, &result);
-	return static_cast<BufferUsage>(result);
+bool StreamBuffer<type>::fits(size_t bytes, size_t alignment) const noexcept {
+	size_t offset, needed;
+	detail::ringPlacement(mHead, mCapacity, bytes, alignment, offset, needed);
+	return needed <= mCapacity - mUnfenced;
 }
 
 template<BufferType type> GLPP_DECL
-void BufferView<type>::debugLabel(std::string_view name) noexcept {
-	glObjectLabel(GL_BUFFER, mHandle, name.size(), name.data());
+void StreamBuffer<type>::retire() noexcept {
+	if(mUnfenced == 0) return;
+	mFences.push_back({ fence(), mUnfenced });
+	mUnfenced = 0;
+}
+
+template<BufferType type> GLPP_DECL
+void StreamBuffer<type>::reclaim(size_t bytes) noexcept {
+	assert(bytes <= mCapacity && "Can't free more than the whole ring");
+	while(mCapacity - mInFlight < bytes) {
+		if(mFences.empty())
+			retire();
+		if(mFences.empty()) return; // Nothing in flight, can't happen while bytes <= mCapacity
+		// Returns right away if the GPU is already done with the region
+		(void) mFences.front().sync.waitClient();
+		mInFlight -= mFences.front().bytes;
+		mFences.pop_front();
+	}
 }
 
 GLPP_DECL
@@ -236,34 +413,222 @@ void copyBufferSubdata(
 	glCopyNamedBufferSubData(srcBuffer, dstBuffer, srcOffset, dstOffset, size);
 }
 
+namespace detail {
+
+struct CopyScratch {
+	GLuint     handle = 0;
+	GLsizeiptr size   = 0;
+};
+
+GLPP_DECL
+CopyScratch& copyScratch() noexcept {
+	thread_local CopyScratch scratch;
+	return scratch;
+}
+
+} // namespace detail
+
+GLPP_DECL
+void releaseCopyScratchBuffer() noexcept {
+	detail::CopyScratch& scratch = detail::copyScratch();
+	if(scratch.handle) {
+		glDeleteBuffers(1, &scratch.handle);
+		scratch = {};
+	}
+}
+
 GLPP_DECL
 void copyBufferSubdataOverlapping(
 	GLuint buffer,
 	GLintptr srcOffset, GLintptr dstOffset,
 	GLsizeiptr size)
 {
+	GLintptr copyStep = std::abs(srcOffset - dstOffset);
+	if(srcOffset == dstOffset || copyStep >= size || size / copyStep <= kCopyInPlaceMaxSteps) {
+		copyBufferSubdataOverlapping(buffer, srcOffset, dstOffset, size, 0, 0);
+		return;
+	}
+
+	detail::CopyScratch& scratch = detail::copyScratch();
+	if(GLsizeiptr wanted = std::min(size, kCopyScratchMaxBytes); scratch.size < wanted) {
+		GLsizeiptr previous = scratch.size; // releaseCopyScratchBuffer() resets it
+		releaseCopyScratchBuffer();
+		scratch.size = std::min(std::max(wanted, previous * 2), kCopyScratchMaxBytes);
+		glCreateBuffers(1, &scratch.handle);
+		glNamedBufferStorage(scratch.handle, scratch.size, nullptr, 0);
+	}
+
+	copyBufferSubdataOverlapping(buffer, srcOffset, dstOffset, size, scratch.handle, scratch.size);
+}
+
+GLPP_DECL
+void copyBufferSubdataOverlapping(
+	GLuint buffer,
+	GLintptr srcOffset, GLintptr dstOffset,
+	GLsizeiptr size,
+	GLuint scratch, GLsizeiptr scratchSize)
+{
+	GLintptr copyStep = std::abs(srcOffset - dstOffset);
+
 	if(srcOffset == dstOffset)
 		return; // Nothing to do!
-	else if(srcOffset >= dstOffset + size || dstOffset >= srcOffset + size) {
+	else if(copyStep >= size) {
 		// No overlap!
 		copyBufferSubdata(buffer, buffer, srcOffset, dstOffset, size);
 	}
+	else if(scratch && scratchSize > 0) {
+		// Bounce chunks through the scratch buffer. Moving towards lower offsets front to back (and the other way around)
+		// never overwrites source bytes that weren't copied yet.
+		GLsizeiptr chunkCount = (size + scratchSize - 1) / scratchSize;
+		for(GLsizeiptr i = 0; i < chunkCount; i++) {
+			GLsizeiptr chunk     = (dstOffset < srcOffset) ? i : chunkCount - 1 - i;
+			GLintptr   offset    = chunk * scratchSize;
+			GLsizeiptr chunkSize = std::min(scratchSize, size - offset);
+			copyBufferSubdata(buffer, scratch, srcOffset + offset, 0, chunkSize);
+			copyBufferSubdata(scratch, buffer, 0, dstOffset + offset, chunkSize);
+		}
+	}
 	else if(dstOffset < srcOffset) {
-		GLintptr copyStep  = std::abs(srcOffset - dstOffset);
 		GLintptr remainder = size % copyStep;
 		for(GLintptr i = 0; i < size / copyStep; i++)
 			copyBufferSubdata(buffer, buffer, srcOffset + i * copyStep, dstOffset + i * copyStep, copyStep);
-		copyBufferSubdata(buffer, buffer, srcOffset + size - remainder, dstOffset + size - remainder, remainder);
+		if(remainder)
+			copyBufferSubdata(buffer, buffer, srcOffset + size - remainder, dstOffset + size - remainder, remainder);
 	}
 	else /* if(dstOffset > srcOffset)  */ {
-		GLintptr copyStep  = std::abs(srcOffset - dstOffset);
 		GLintptr remainder = size % copyStep;
-		copyBufferSubdata(buffer, buffer, srcOffset + size - remainder, dstOffset + size - remainder, remainder);
+		if(remainder)
+			copyBufferSubdata(buffer, buffer, srcOffset + size - remainder, dstOffset + size - remainder, remainder);
 		for(GLintptr i = (size / copyStep) - 1; i >= 0; i--)
 			copyBufferSubdata(buffer, buffer, srcOffset + i * copyStep, dstOffset + i * copyStep, copyStep);
 	}
+}
+
+namespace detail {
+
+// Unsigned integer formats, so the pattern is copied bit by bit without any conversion
+GLPP_DECL
+void clearFormat(size_t patternSize, GLenum& internalFormat, GLenum& format) noexcept {
+	switch(patternSize) {
+	case 1:  internalFormat = GL_R8UI;      format = GL_RED_INTEGER;  break;
+	case 2:  internalFormat = GL_R16UI;     format = GL_RED_INTEGER;  break;
+	case 4:  internalFormat = GL_R32UI;     format = GL_RED_INTEGER;  break;
+	case 8:  internalFormat = GL_RG32UI;    format = GL_RG_INTEGER;   break;
+	case 12: internalFormat = GL_RGB32UI;   format = GL_RGB_INTEGER;  break;
+	case 16: internalFormat = GL_RGBA32UI;  format = GL_RGBA_INTEGER; break;
+	default: assert(false && "Clear patterns have to be 1, 2, 4, 8, 12 or 16 bytes");
+	}
+}
+
+GLPP_DECL
+GLenum clearType(size_t patternSize) noexcept {
+	return patternSize == 1 ? GL_UNSIGNED_BYTE : patternSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
 
-	// TODO: make more efficient for very small copySteps and large buffers (maybe use auxiliary buffers?)
+GLPP_DECL
+void clearBuffer(unsigned buffer, void const* pattern, size_t patternSize) noexcept {
+	GLenum internalFormat = GL_R8UI, format = GL_RED_INTEGER;
+	clearFormat(patternSize, internalFormat, format);
+	glClearNamedBufferData(buffer, internalFormat, format, clearType(patternSize), pattern);
+}
+
+GLPP_DECL
+void clearBuffer(unsigned buffer, size_t offset, size_t bytes, void const* pattern, size_t patternSize) noexcept {
+	assert(offset % patternSize == 0 && bytes % patternSize == 0 && "Cleared range has to be a multiple of the pattern size");
+	GLenum internalFormat = GL_R8UI, format = GL_RED_INTEGER;
+	clearFormat(patternSize, internalFormat, format);
+	glClearNamedBufferSubData(buffer, internalFormat, offset, bytes, format, clearType(patternSize), pattern);
+}
+
+constexpr GLuint kScatterGatherGroupSize = 64;
+
+constexpr const char* kScatterGatherSource = R"glsl(#version 430
+layout(local_size_x = 64) in;
+
+layout(std430, binding = 0) writeonly buffer Destination { uint dst[]; };
+layout(std430, binding = 1) readonly  buffer Source      { uint src[]; };
+layout(std430, binding = 2) readonly  buffer Indices     { uint indices[]; };
+
+uniform uint uFirst;
+uniform uint uCount;
+uniform uint uWords;
+uniform bool uGather;
+
+void main() {
+	uint i = uFirst + gl_GlobalInvocationID.x;
+	if(i >= uCount) return;
+
+	uint d = uGather ? i : indices[i];
+	uint s = uGather ? indices[i] : i;
+	for(uint w = 0u; w < uWords; w++)
+		dst[d * uWords + w] = src[s * uWords + w];
+}
+)glsl";
+
+struct ScatterGatherProgram {
+	GLuint handle = 0;
+	GLint  first = -1, count = -1, words = -1, gather = -1; // Uniform locations
+};
+
+GLPP_DECL
+ScatterGatherProgram& scatterGatherProgram() noexcept {
+	thread_local ScatterGatherProgram program;
+	return program;
+}
+
+GLPP_DECL
+void scatterGather(bool gather, unsigned dst, unsigned src, unsigned indices, size_t count, size_t elementSize) noexcept {
+	assert(elementSize > 0 && elementSize % 4 == 0 && "Scattered/gathered elements have to be a multiple of 4 bytes");
+	assert(count <= UINT32_MAX);
+	if(count == 0) return;
+
+	ScatterGatherProgram& program = scatterGatherProgram();
+	if(!program.handle) {
+		program.handle = glCreateShaderProgramv(GL_COMPUTE_SHADER, 1, &kScatterGatherSource);
+		#ifndef NDEBUG
+			GLint linked = GL_FALSE;
+			glGetProgramiv(program.handle, GL_LINK_STATUS, &linked);
+			assert(linked == GL_TRUE && "Failed to build the scatter/gather compute shader");
+		#endif
+		program.first  = glGetUniformLocation(program.handle, "uFirst");
+		program.count  = glGetUniformLocation(program.handle, "uCount");
+		program.words  = glGetUniformLocation(program.handle, "uWords");
+		program.gather = glGetUniformLocation(program.handle, "uGather");
+	}
+
+	GLint previousProgram = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+
+	glUseProgram(program.handle);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, dst);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, src);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, indices);
+	glProgramUniform1ui(program.handle, program.count,  GLuint(count));
+	glProgramUniform1ui(program.handle, program.words,  GLuint(elementSize / 4));
+	glProgramUniform1i (program.handle, program.gather, gather);
+
+	// 65535 groups is the smallest maximum dispatch size allowed by the spec
+	constexpr size_t kMaxPerDispatch = 65535 * kScatterGatherGroupSize;
+	for(size_t first = 0; first < count; first += kMaxPerDispatch) {
+		size_t n = std::min(count - first, kMaxPerDispatch);
+		glProgramUniform1ui(program.handle, program.first, GLuint(first));
+		glDispatchCompute(GLuint((n + kScatterGatherGroupSize - 1) / kScatterGatherGroupSize), 1, 1);
+	}
+
+	// The destination may be used in any way afterwards
+	glMemoryBarrier(GL_ALL_BARRIER_BITS);
+	glUseProgram(previousProgram);
+}
+
+} // namespace detail
+
+GLPP_DECL
+void releaseScatterGatherProgram() noexcept {
+	detail::ScatterGatherProgram& program = detail::scatterGatherProgram();
+	if(program.handle) {
+		glDeleteProgram(program.handle);
+		program = {};
+	}
 }
 
 /*_            __  __               _
@@ -287,4 +652,18 @@ template class Buffer<SHADER_STORAGE_BUFFER>;
 template class Buffer<TRANSFORM_FEEDBACK_BUFFER>;
 template class Buffer<UNIFORM_BUFFER>;
 
+template class StreamBuffer<ARRAY_BUFFER>;
+template class StreamBuffer<ATOMIC_COUNTER_BUFFER>;
+template class StreamBuffer<COPY_READ_BUFFER>;
+template class StreamBuffer<COPY_WRITE_BUFFER>;
+template class StreamBuffer<DRAW_INDIRECT_BUFFER>;
+template class StreamBuffer<DISPATCH_INDIRECT_BUFFER>;
+template class StreamBuffer<ELEMENT_ARRAY_BUFFER>;
+template class StreamBuffer<PIXEL_PACK_BUFFER>;
+template class StreamBuffer<PIXEL_UNPACK_BUFFER>;
+template class StreamBuffer<QUERY_BUFFER>;
+template class StreamBuffer<SHADER_STORAGE_BUFFER>;
+template class StreamBuffer<TRANSFORM_FEEDBACK_BUFFER>;
+template class StreamBuffer<UNIFORM_BUFFER>;
+
 } // namespace gl
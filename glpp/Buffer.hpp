@@ -1,9 +1,12 @@
 #pragma once
 
 #include "Enums.hpp"
+#include "Sync.hpp"
 
 #include <GL/glew.h>
 
+#include <deque>
+#include <memory>
 #include <type_traits>
 #include <string_view>
 
@@ -74,19 +77,68 @@ __GLPP_ENUM_BITFIELD_OPERATORS(BufferMappingBits);
 
 namespace detail {
 
+// Client side copy of a buffer's state, kept up to date by gl::Buffer so the getters don't have to ask the driver
+struct BufferInfo {
+	size_t            size         = 0;
+	BufferUsage       usage        = STATIC_DRAW;
+	BufferStorageBits storageFlags = STORAGE_DEFAULT;
+	bool              immutable    = false;
+	bool              mapped       = false;
+	BufferAccess      access       = READ_WRITE;
+	BufferMappingBits accessFlags  = {};
+	size_t            mapOffset    = 0;
+	size_t            mapLength    = 0;
+
+	void unmapped() noexcept { mapped = false; access = READ_WRITE; accessFlags = {}; mapOffset = mapLength = 0; }
+};
+
 struct BufferUnmapper {
-	unsigned handle;
-	void operator()(void* ptr) noexcept { glUnmapNamedBuffer(handle); }
+	unsigned    handle;
+	BufferInfo* info = nullptr;
+	void operator()(void* ptr) noexcept { glUnmapNamedBuffer(handle); if(info) info->unmapped(); }
 };
 template<class T = void>
 using BufferMapping = std::unique_ptr<T, BufferUnmapper>;
 
+// Where the next allocation of a ring buffer goes and how many bytes it takes up, including padding and space wasted by wrapping around
+void ringPlacement(size_t head, size_t capacity, size_t bytes, size_t alignment, size_t& offset, size_t& needed) noexcept;
+
+// Fills the buffer (or a range of it) with a raw bit pattern of 1, 2, 4, 8, 12 or 16 bytes
+void clearBuffer(unsigned buffer, void const* pattern, size_t patternSize) noexcept;
+void clearBuffer(unsigned buffer, size_t offset, size_t bytes, void const* pattern, size_t patternSize) noexcept;
+
+template<class T>
+constexpr void checkClearPattern() noexcept {
+	static_assert(std::is_trivially_copyable_v<T>, "Clear patterns are copied bit by bit");
+	static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8 || sizeof(T) == 12 || sizeof(T) == 16, "Clear patterns have to be 1, 2, 4, 8, 12 or 16 bytes");
+}
+
+// Copies dst[indices[i]] = src[i] (or dst[i] = src[indices[i]] if `gather` is set) for i < count with a compute shader, leaving shader storage bindings 0 to 2 pointing at dst, src and indices
+void scatterGather(bool gather, unsigned dst, unsigned src, unsigned indices, size_t count, size_t elementSize) noexcept;
+
 } // namespace detail
 
+/// A range of bytes inside a buffer object, e.g. handed out by gl::BufferHeap or gl::StreamBuffer
+struct BufferSlice {
+	unsigned handle = 0;
+	size_t   offset = 0;
+	size_t   size   = 0;
+
+	void bindRange(GLuint index, BufferType as) const noexcept { glBindBufferRange(as, index, handle, offset, size); }
+
+	/// Offsets are relative to the start of the slice
+	void subdata(size_t offset, size_t bytes, void const* data) const noexcept { glNamedBufferSubData(handle, this->offset + offset, bytes, data); }
+	void getData(size_t offset, size_t bytes, void* to) const noexcept { glGetNamedBufferSubData(handle, this->offset + offset, bytes, to); }
+	template<class T> void clear(T const& pattern) const noexcept { detail::checkClearPattern<T>(); detail::clearBuffer(handle, offset, size, &pattern, sizeof(T)); }
+
+	explicit operator bool() const noexcept { return handle != 0; }
+};
+
 template<BufferType kBufferType>
 class BufferView {
 protected:
-	unsigned mHandle = 0;
+	unsigned            mHandle = 0;
+	detail::BufferInfo* mShadow = nullptr; // Owned by the gl::Buffer this is a view of, if any
 public:
 	explicit BufferView(unsigned handle = 0) : mHandle(handle) {}
 
@@ -107,10 +159,21 @@ public:
 	template<class ContainerT> void data(BufferUsage usage, ContainerT const& c) noexcept { data(usage, std::size(c), std::data(c)); }
 	template<class ContainerT> void subdata(size_t offset_index, ContainerT const& c) noexcept { subdata(offset_index, std::size(c), std::data(c)); }
 
-	// TODO:
-	// glClearBuffer
-	// glClearBufferSubData
-	// glCopyBufferSubData
+	/// Fills the buffer with copies of `pattern` without a CPU side copy, sizeof(T) has to be 1, 2, 4, 8, 12 or 16. `offset` and `bytes` need to be multiples of sizeof(T).
+	template<class T> void clear(T const& pattern) noexcept { detail::checkClearPattern<T>(); detail::clearBuffer(mHandle, &pattern, sizeof(T)); }
+	template<class T> void clear(size_t offset, size_t bytes, T const& pattern) noexcept { detail::checkClearPattern<T>(); detail::clearBuffer(mHandle, offset, bytes, &pattern, sizeof(T)); }
+	/// Raw glClearNamedBufferData, converting `data` from `format`/`type` to `internalFormat`. `data` may be nullptr to fill with zeros
+	void clear(GLenum internalFormat, GLenum format, BasicType pxtype, void const* data) noexcept;
+	void clear(size_t offset, size_t bytes, GLenum internalFormat, GLenum format, BasicType pxtype, void const* data) noexcept;
+
+	/// Writes element i of the `values` buffer to element indices[i] of this buffer for all i < count, entirely on the GPU.
+	/// `indices` holds uint32s, elementSize has to be a multiple of 4. Indices should be unique, otherwise which write wins is undefined.
+	/// Runs a compute shader, so shader storage bindings 0 to 2 are overwritten and not restored. (The current program is kept)
+	void scatter(unsigned indices, unsigned values, size_t count, size_t elementSize) noexcept;
+	template<class T> void scatter(unsigned indices, unsigned values, size_t count) noexcept { scatter(indices, values, count, sizeof(T)); }
+	/// The opposite of scatter: Reads element indices[i] of this buffer into element i of `destination`
+	void gather(unsigned indices, unsigned destination, size_t count, size_t elementSize) noexcept;
+	template<class T> void gather(unsigned indices, unsigned destination, size_t count) noexcept { gather(indices, destination, count, sizeof(T)); }
 
 	void* getPointer() noexcept;
 
@@ -125,7 +188,8 @@ public:
 
 	void flushMappedRange(size_t offset, size_t length) noexcept;
 
-	// Getters
+	// Getters: Plain member reads on a gl::Buffer (or a view copied from one), driver queries otherwise.
+	// Debug builds compare the two, so modifying a gl::Buffer through its raw handle trips an assert.
 	BufferAccess      access()       noexcept;
 	BufferMappingBits accessFlags()  noexcept;
 	bool              immutable()    noexcept;
@@ -161,6 +225,66 @@ public:
 
 	void init() noexcept;
 	void destroy() noexcept;
+
+private:
+	std::unique_ptr<detail::BufferInfo> mInfo; // On the heap so views and mappings stay valid when the buffer is moved
+};
+
+/// A persistently mapped ring buffer for streaming data to the GPU every frame.
+/// Regions returned by allocate() can be written right away and used in GL commands; call retire() once those commands were submitted (e.g. once per frame) to fence them.
+/// allocate() only blocks if the ring is full of regions the GPU hasn't finished reading yet.
+/// If the ring runs out of space before retire() is called, everything allocated so far is assumed to be submitted and gets fenced.
+template<BufferType kBufferType>
+class StreamBuffer {
+	struct Fence {
+		Sync   sync;
+		size_t bytes;
+	};
+
+	Buffer<kBufferType>     mBuffer;
+	detail::BufferMapping<> mMapping;
+	size_t                  mCapacity = 0;
+	size_t                  mHead     = 0; // Next byte to hand out
+	size_t                  mInFlight = 0; // Bytes handed out and not yet known to be consumed by the GPU (including wasted bytes at the end of the ring)
+	size_t                  mUnfenced = 0; // Bytes of mInFlight not covered by a fence yet
+	std::deque<Fence>       mFences;
+
+	void reclaim(size_t bytes) noexcept;
+public:
+	struct Region : BufferSlice {
+		void* data;
+	};
+
+	StreamBuffer(std::nullptr_t) noexcept;
+	explicit StreamBuffer(size_t capacity, BufferStorageBits extraFlags = STORAGE_DEFAULT) noexcept;
+	~StreamBuffer() noexcept;
+
+	StreamBuffer(StreamBuffer&& other) noexcept;
+	StreamBuffer& operator=(StreamBuffer&& other) noexcept;
+	StreamBuffer(StreamBuffer const& other) noexcept = delete;
+	StreamBuffer& operator=(StreamBuffer const& other) noexcept = delete;
+
+	void init(size_t capacity, BufferStorageBits extraFlags = STORAGE_DEFAULT) noexcept;
+	void destroy() noexcept;
+
+	/// Hands out `bytes` of writable memory, the offset is a multiple of `alignment`. `bytes` can be up to capacity().
+	/// When the region doesn't fit before the end of the ring and wrapping around would need more than the whole ring, waits for everything in flight and starts over at 0.
+	[[nodiscard]] Region allocate(size_t bytes, size_t alignment = 1) noexcept;
+	/// allocate() and copy `data` into the region
+	Region push(void const* data, size_t bytes, size_t alignment = 1) noexcept;
+	template<class T> Region push(T const& value, size_t alignment = alignof(T)) noexcept { return push(&value, sizeof(T), alignment); }
+
+	/// Fences all regions allocated since the last call
+	void retire() noexcept;
+
+	size_t capacity() const noexcept { return mCapacity; }
+	/// Bytes that can currently be allocated without waiting on or fencing anything
+	size_t available() const noexcept { return mCapacity - mInFlight; }
+	/// Whether allocate() would succeed without fencing regions that weren't retired yet (it may still wait for the GPU)
+	bool fits(size_t bytes, size_t alignment = 1) const noexcept;
+
+	BufferView<kBufferType> buffer() const noexcept { return mBuffer; }
+	operator unsigned() const noexcept { return mBuffer; }
 };
 
 void copyBufferSubdata(
@@ -168,10 +292,26 @@ void copyBufferSubdata(
 	GLintptr srcOffset, GLintptr dstOffset,
 	GLsizeiptr size);
 /// Safe helper function for moving memory withing one buffer. (The normal method doesn't allow overlapping ranges)
+/// Moves by a small distance relative to their size are staged through a pooled per-thread scratch buffer, taking two copies per chunk of up to kCopyScratchMaxBytes instead of one copy per step.
 void copyBufferSubdataOverlapping(
 	GLuint buffer,
 	GLintptr srcOffset, GLintptr dstOffset,
 	GLsizeiptr size);
+/// Same as above, but stages through the given `scratch` buffer of `scratchSize` bytes instead of the pooled one
+void copyBufferSubdataOverlapping(
+	GLuint buffer,
+	GLintptr srcOffset, GLintptr dstOffset,
+	GLsizeiptr size,
+	GLuint scratch, GLsizeiptr scratchSize);
+/// Deletes the calling thread's pooled scratch buffer of copyBufferSubdataOverlapping. Call before destroying the context if you care about leaks.
+void releaseCopyScratchBuffer() noexcept;
+/// Deletes the calling thread's compute program used by BufferView::scatter and gather, same as above.
+void releaseScatterGatherProgram() noexcept;
+
+/// Upper limit for the pooled scratch buffer of copyBufferSubdataOverlapping, bigger moves are done in chunks
+constexpr GLsizeiptr kCopyScratchMaxBytes = 8 << 20;
+/// Overlapping moves needing at most this many in-place copies skip the scratch buffer
+constexpr GLsizeiptr kCopyInPlaceMaxSteps = 4;
 
 inline namespace buffer_types {
 	using ArrayBuffer             = Buffer<ARRAY_BUFFER>;
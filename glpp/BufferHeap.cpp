@@ -0,0 +1,255 @@
+#include "BufferHeap.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+namespace detail {
+
+GLPP_DECL
+unsigned findFirstSet(uint32_t x) noexcept {
+	assert(x != 0);
+	#ifdef _MSC_VER
+		unsigned long result;
+		_BitScanForward(&result, x);
+		return result;
+	#else
+		return __builtin_ctz(x);
+	#endif
+}
+
+GLPP_DECL
+unsigned findLastSet(uint64_t x) noexcept {
+	assert(x != 0);
+	#ifdef _MSC_VER
+		unsigned long result;
+		_BitScanReverse64(&result, x);
+		return result;
+	#else
+		return 63 - __builtin_clzll(x);
+	#endif
+}
+
+// Maps a size (in allocation units) to its free list
+GLPP_DECL
+void tlsfMapping(size_t units, unsigned kSecondLevels, unsigned& fl, unsigned& sl) noexcept {
+	if(units < (size_t(1) << kSecondLevels)) {
+		fl = 0;
+		sl = unsigned(units);
+	}
+	else {
+		unsigned t = detail::findLastSet(units);
+		sl = unsigned(units >> (t - kSecondLevels)) ^ (1u << kSecondLevels);
+		fl = t - kSecondLevels + 1;
+	}
+}
+
+} // namespace detail
+
+GLPP_DECL
+BufferHeap::BufferHeap(std::nullptr_t) noexcept :
+	mBuffer(nullptr)
+{
+	std::fill(&mFreeLists[0][0], &mFreeLists[0][0] + kFirstLevels * (1 << kSecondLevels), kNil);
+}
+
+GLPP_DECL
+BufferHeap::BufferHeap(size_t capacity, BufferStorageBits flags, size_t alignment) noexcept :
+	BufferHeap(nullptr)
+{
+	init(capacity, flags, alignment);
+}
+
+GLPP_DECL
+void BufferHeap::init(size_t capacity, BufferStorageBits flags, size_t alignment) noexcept {
+	assert(alignment > 0 && capacity >= alignment);
+	destroy();
+
+	mAlignment = alignment;
+	mCapacity  = capacity / alignment * alignment;
+	assert(mCapacity / mAlignment <= UINT32_MAX && "Too many allocation units, increase the alignment");
+
+	mBuffer.init();
+	mBuffer.storage(flags, mCapacity);
+
+	insertFree(newBlock({ 0, mCapacity, kNil, kNil, kNil, kNil, true }));
+}
+
+GLPP_DECL
+void BufferHeap::destroy() noexcept {
+	mBuffer.destroy();
+	mCapacity = mUsed = mAllocations = 0;
+	mBlocks.clear();
+	mUnusedBlocks.clear();
+	mFirstLevelBitmap = 0;
+	std::fill(std::begin(mSecondLevelBitmaps), std::end(mSecondLevelBitmaps), 0);
+	std::fill(&mFreeLists[0][0], &mFreeLists[0][0] + kFirstLevels * (1 << kSecondLevels), kNil);
+}
+
+GLPP_DECL
+auto BufferHeap::allocate(size_t bytes) noexcept
+	-> Allocation
+{
+	if(bytes == 0 || bytes > mCapacity) return {};
+
+	size_t units = (bytes + mAlignment - 1) / mAlignment;
+	bytes = units * mAlignment;
+
+	// Round up to the next list boundary, so every block in the found list is big enough
+	size_t searchUnits = units;
+	if(searchUnits >= (size_t(1) << kSecondLevels))
+		searchUnits += (size_t(1) << (detail::findLastSet(searchUnits) - kSecondLevels)) - 1;
+
+	unsigned fl, sl;
+	detail::tlsfMapping(searchUnits, kSecondLevels, fl, sl);
+	if(fl >= kFirstLevels) return {};
+
+	uint32_t slMap = mSecondLevelBitmaps[fl] & (~0u << sl);
+	if(!slMap) {
+		uint32_t flMap = (fl + 1 < kFirstLevels) ? mFirstLevelBitmap & (~0u << (fl + 1)) : 0;
+		if(!flMap) return {}; // Out of memory
+		fl    = detail::findFirstSet(flMap);
+		slMap = mSecondLevelBitmaps[fl];
+	}
+	sl = detail::findFirstSet(slMap);
+
+	uint32_t index = mFreeLists[fl][sl];
+	removeFree(index);
+
+	// Split off the rest
+	if(size_t remaining = mBlocks[index].size - bytes; remaining >= mAlignment) {
+		Block const& b = mBlocks[index];
+		uint32_t rest = newBlock({ b.offset + bytes, remaining, index, b.nextPhysical, kNil, kNil, true });
+		if(mBlocks[rest].nextPhysical != kNil)
+			mBlocks[mBlocks[rest].nextPhysical].prevPhysical = rest;
+		mBlocks[index].nextPhysical = rest;
+		mBlocks[index].size         = bytes;
+		insertFree(rest);
+	}
+
+	Block& block = mBlocks[index];
+	block.free = false;
+	mUsed += block.size;
+	mAllocations++;
+
+	Allocation result;
+	result.handle = mBuffer;
+	result.offset = block.offset;
+	result.size   = block.size;
+	result.block  = index;
+	return result;
+}
+
+GLPP_DECL
+void BufferHeap::free(Allocation const& allocation) noexcept {
+	if(allocation.block == kNil) return;
+	assert(allocation.block < mBlocks.size() && !mBlocks[allocation.block].free && mBlocks[allocation.block].offset == allocation.offset && "Allocation doesn't belong to this heap or was freed twice");
+
+	uint32_t index = allocation.block;
+	mBlocks[index].free = true;
+	mUsed -= mBlocks[index].size;
+	mAllocations--;
+
+	// Merge with the previous block
+	if(uint32_t prev = mBlocks[index].prevPhysical; prev != kNil && mBlocks[prev].free) {
+		removeFree(prev);
+		mBlocks[prev].size        += mBlocks[index].size;
+		mBlocks[prev].nextPhysical = mBlocks[index].nextPhysical;
+		if(mBlocks[prev].nextPhysical != kNil)
+			mBlocks[mBlocks[prev].nextPhysical].prevPhysical = prev;
+		mUnusedBlocks.push_back(index);
+		index = prev;
+	}
+
+	// Merge with the next block
+	if(uint32_t next = mBlocks[index].nextPhysical; next != kNil && mBlocks[next].free) {
+		removeFree(next);
+		mBlocks[index].size        += mBlocks[next].size;
+		mBlocks[index].nextPhysical = mBlocks[next].nextPhysical;
+		if(mBlocks[index].nextPhysical != kNil)
+			mBlocks[mBlocks[index].nextPhysical].prevPhysical = index;
+		mUnusedBlocks.push_back(next);
+	}
+
+	insertFree(index);
+}
+
+GLPP_DECL
+auto BufferHeap::stats() const noexcept
+	-> Stats
+{
+	Stats result = {};
+	result.capacity    = mCapacity;
+	result.used        = mUsed;
+	result.free        = mCapacity - mUsed;
+	result.allocations = mAllocations;
+
+	for(unsigned fl = 0; fl < kFirstLevels; fl++) {
+		for(unsigned sl = 0; sl < (1u << kSecondLevels); sl++) {
+			for(uint32_t i = mFreeLists[fl][sl]; i != kNil; i = mBlocks[i].nextFree) {
+				result.freeBlocks++;
+				result.largestFree = std::max(result.largestFree, mBlocks[i].size);
+			}
+		}
+	}
+
+	return result;
+}
+
+GLPP_DECL
+uint32_t BufferHeap::newBlock(Block const& b) noexcept {
+	if(!mUnusedBlocks.empty()) {
+		uint32_t index = mUnusedBlocks.back();
+		mUnusedBlocks.pop_back();
+		mBlocks[index] = b;
+		return index;
+	}
+	mBlocks.push_back(b);
+	return uint32_t(mBlocks.size() - 1);
+}
+
+GLPP_DECL
+void BufferHeap::insertFree(uint32_t index) noexcept {
+	Block& b = mBlocks[index];
+	unsigned fl, sl;
+	detail::tlsfMapping(b.size / mAlignment, kSecondLevels, fl, sl);
+
+	b.free     = true;
+	b.prevFree = kNil;
+	b.nextFree = mFreeLists[fl][sl];
+	if(b.nextFree != kNil)
+		mBlocks[b.nextFree].prevFree = index;
+	mFreeLists[fl][sl] = index;
+
+	mFirstLevelBitmap       |= 1u << fl;
+	mSecondLevelBitmaps[fl] |= 1u << sl;
+}
+
+GLPP_DECL
+void BufferHeap::removeFree(uint32_t index) noexcept {
+	Block& b = mBlocks[index];
+	unsigned fl, sl;
+	detail::tlsfMapping(b.size / mAlignment, kSecondLevels, fl, sl);
+
+	if(b.prevFree != kNil) mBlocks[b.prevFree].nextFree = b.nextFree;
+	else                   mFreeLists[fl][sl]           = b.nextFree;
+	if(b.nextFree != kNil) mBlocks[b.nextFree].prevFree = b.prevFree;
+
+	if(mFreeLists[fl][sl] == kNil) {
+		mSecondLevelBitmaps[fl] &= ~(1u << sl);
+		if(!mSecondLevelBitmaps[fl])
+			mFirstLevelBitmap &= ~(1u << fl);
+	}
+}
+
+} // namespace gl
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Buffer.hpp"
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace gl {
+
+/// Sub-allocates ranges of a single immutable buffer object, so thousands of small buffers don't need thousands of handles.
+/// Uses a TLSF (two-level segregated fit) allocator: allocate() and free() are O(1).
+/// All bookkeeping lives on the CPU, the buffer memory itself is never touched.
+class BufferHeap {
+public:
+	/// The allocated range, remembers its block so free() doesn't need to search
+	struct Allocation : BufferSlice {
+		uint32_t block = UINT32_MAX;
+	};
+
+	struct Stats {
+		size_t capacity;
+		size_t used;
+		size_t free;
+		size_t largestFree;  // Biggest allocation that would currently succeed
+		size_t allocations;
+		size_t freeBlocks;
+
+		/// 0 if all free memory is one contiguous block, approaching 1 the more it is scattered
+		float fragmentation() const noexcept { return free == 0 ? 0.f : 1.f - float(largestFree) / float(free); }
+	};
+
+	BufferHeap(std::nullptr_t) noexcept;
+	/// `alignment` is the granularity of all allocations, every offset is a multiple of it. (256 satisfies all uniform/storage buffer offset alignments seen in the wild)
+	explicit BufferHeap(size_t capacity, BufferStorageBits flags = STORAGE_DYNAMIC_BIT, size_t alignment = 256) noexcept;
+
+	BufferHeap(BufferHeap&& other) noexcept = default;
+	BufferHeap& operator=(BufferHeap&& other) noexcept = default;
+	BufferHeap(BufferHeap const& other) = delete;
+	BufferHeap& operator=(BufferHeap const& other) = delete;
+
+	void init(size_t capacity, BufferStorageBits flags = STORAGE_DYNAMIC_BIT, size_t alignment = 256) noexcept;
+	void destroy() noexcept;
+
+	/// Returns an empty allocation (operator bool() == false) if no free block is big enough
+	[[nodiscard]] Allocation allocate(size_t bytes) noexcept;
+	void free(Allocation const& allocation) noexcept;
+
+	/// Walks the free lists, meant for diagnostics rather than every frame
+	Stats  stats() const noexcept;
+	size_t capacity() const noexcept { return mCapacity; }
+	size_t alignment() const noexcept { return mAlignment; }
+
+	BufferView<COPY_WRITE_BUFFER> buffer() const noexcept { return mBuffer; }
+	operator unsigned() const noexcept { return mBuffer; }
+
+private:
+	constexpr static uint32_t kNil          = UINT32_MAX;
+	constexpr static unsigned kSecondLevels = 4; // log2 of the number of second level lists per first level
+	constexpr static unsigned kFirstLevels  = 32;
+
+	struct Block {
+		size_t   offset;
+		size_t   size;
+		uint32_t prevPhysical, nextPhysical;
+		uint32_t prevFree, nextFree;
+		bool     free;
+	};
+
+	CopyWriteBuffer       mBuffer;
+	size_t                mCapacity  = 0;
+	size_t                mAlignment = 1;
+	size_t                mUsed      = 0;
+	size_t                mAllocations = 0;
+	std::vector<Block>    mBlocks;
+	std::vector<uint32_t> mUnusedBlocks; // Recycled entries of mBlocks
+	uint32_t              mFirstLevelBitmap = 0;
+	uint32_t              mSecondLevelBitmaps[kFirstLevels] = {};
+	uint32_t              mFreeLists[kFirstLevels][1 << kSecondLevels];
+
+	uint32_t newBlock(Block const& b) noexcept;
+	void     insertFree(uint32_t block) noexcept;
+	void     removeFree(uint32_t block) noexcept;
+};
+
+} // namespace gl
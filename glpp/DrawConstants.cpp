@@ -0,0 +1,38 @@
+#include "DrawConstants.hpp"
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+template<BufferType type> GLPP_DECL
+DrawConstants<type>::DrawConstants(std::nullptr_t) noexcept :
+	mRing(nullptr)
+{}
+
+template<BufferType type> GLPP_DECL
+DrawConstants<type>::DrawConstants(size_t capacity) noexcept :
+	DrawConstants(nullptr)
+{
+	init(capacity);
+}
+
+template<BufferType type> GLPP_DECL
+void DrawConstants<type>::init(size_t capacity) noexcept {
+	GLint alignment = 1;
+	glGetIntegerv(type == UNIFORM_BUFFER ? GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT : GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	mAlignment = size_t(alignment);
+	mRing.init(capacity);
+}
+
+template<BufferType type> GLPP_DECL
+void DrawConstants<type>::destroy() noexcept {
+	mRing.destroy();
+	mAlignment = 1;
+}
+
+template class DrawConstants<UNIFORM_BUFFER>;
+template class DrawConstants<SHADER_STORAGE_BUFFER>;
+
+} // namespace gl
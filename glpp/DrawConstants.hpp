@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Buffer.hpp"
+
+#include <GL/glew.h>
+
+#include <cassert>
+#include <cstddef>
+
+namespace gl {
+
+/// Per-draw data (model matrices, material parameters, ...) written into one persistently mapped ring,
+/// so every draw costs a single glBindBufferRange instead of a glUniform* call per value.
+///
+/// With UNIFORM_BUFFER, push() one block per draw and bind() it right before the draw:
+///
+///     for(Object const& o : objects) {
+///         constants.bind(1, constants.push(o.block));
+///         drawElements(...);
+///     }
+///     constants.retire(); // Once per frame
+///
+/// With SHADER_STORAGE_BUFFER, allocateArray() the blocks of all draws, bind() them once and pass each draw's
+/// element index as baseInstance, see drawElementsInstancedBaseInstance(). The shader indexes with gl_BaseInstance
+/// (GL 4.6 or ARB_shader_draw_parameters), or with an instanced vertex attribute holding 0, 1, 2, ...
+template<BufferType kBufferType>
+class DrawConstants {
+	static_assert(kBufferType == UNIFORM_BUFFER || kBufferType == SHADER_STORAGE_BUFFER);
+
+	StreamBuffer<kBufferType> mRing;
+	size_t                    mAlignment = 1; // GL_*_BUFFER_OFFSET_ALIGNMENT
+public:
+	using Region = typename StreamBuffer<kBufferType>::Region;
+
+	DrawConstants(std::nullptr_t) noexcept;
+	/// `capacity` should hold about three frames worth of blocks, allocations wait for the GPU once it's full
+	explicit DrawConstants(size_t capacity) noexcept;
+
+	DrawConstants(DrawConstants&& other) noexcept = default;
+	DrawConstants& operator=(DrawConstants&& other) noexcept = default;
+	DrawConstants(DrawConstants const& other) = delete;
+	DrawConstants& operator=(DrawConstants const& other) = delete;
+
+	void init(size_t capacity) noexcept;
+	void destroy() noexcept;
+
+	/// Room for one block, aligned so it can be bound on its own. Anything up to capacity() fits, but allocations
+	/// that don't fit before the end of the ring may wait for every earlier one, so keep a frame's worth well below that
+	[[nodiscard]] Region allocate(size_t bytes) noexcept {
+		assert(bytes <= capacity() && "Allocation doesn't fit into the DrawConstants ring");
+		return mRing.allocate(bytes, mAlignment);
+	}
+	Region push(void const* data, size_t bytes) noexcept { return mRing.push(data, bytes, mAlignment); }
+	template<class T> Region push(T const& block) noexcept { return push(&block, sizeof(T)); }
+	/// Room for `count` consecutive blocks of `stride` bytes (the std140/std430 array stride, see layout::stride), count * stride is limited like above
+	[[nodiscard]] Region allocateArray(size_t count, size_t stride) noexcept { return allocate(count * stride); }
+
+	void bind(GLuint index, BufferSlice const& slice) const noexcept { slice.bindRange(index, kBufferType); }
+
+	/// Fences everything allocated since the last call, call it once per frame
+	void retire() noexcept { mRing.retire(); }
+
+	size_t alignment() const noexcept { return mAlignment; }
+	size_t capacity() const noexcept { return mRing.capacity(); }
+	/// Bytes a block of `bytes` takes up in the ring, not counting waste from wrapping around
+	size_t footprint(size_t bytes) const noexcept { return (bytes + mAlignment - 1) / mAlignment * mAlignment; }
+
+	BufferView<kBufferType> buffer() const noexcept { return mRing.buffer(); }
+	operator unsigned() const noexcept { return mRing; }
+};
+
+using UniformConstants = DrawConstants<UNIFORM_BUFFER>;
+using StorageConstants = DrawConstants<SHADER_STORAGE_BUFFER>;
+
+} // namespace gl
@@ -55,6 +55,17 @@ void drawElementsInstanced(uint32_t instanceCount, Topography topo, BasicType ty
 	drawElementsInstanced(instanceCount, topo, type, 0, count);
 }
 
+/// Instance i reads instanced attributes at element baseInstance + i, and gl_BaseInstance is baseInstance
+inline
+void drawElementsInstancedBaseInstance(uint32_t instanceCount, uint32_t baseInstance, Topography topo, BasicType type, uint32_t firstIndex, uint32_t count) noexcept {
+	glDrawElementsInstancedBaseInstance(topo, count, type, (void*)(firstIndex * sizeOf(type)), instanceCount, baseInstance);
+}
+
+inline
+void drawArraysInstancedBaseInstance(uint32_t instanceCount, uint32_t baseInstance, Topography topo, int count, int first = 0) noexcept {
+	glDrawArraysInstancedBaseInstance(topo, first, count, instanceCount, baseInstance);
+}
+
 inline
 void drawArrays(Topography topo, int count, int first = 0) noexcept {
 	glDrawArrays(topo, first, count);
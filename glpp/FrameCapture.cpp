@@ -0,0 +1,179 @@
+#include "FrameCapture.hpp"
+
+#include "ThreadPool.hpp"
+
+#include <thread>
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+GLPP_DECL
+FrameCapture::FrameCapture(std::nullptr_t) noexcept {}
+
+GLPP_DECL
+FrameCapture::FrameCapture(ThreadPool& pool, unsigned buffers) noexcept :
+	FrameCapture(nullptr)
+{
+	init(pool, buffers);
+}
+
+GLPP_DECL
+FrameCapture::~FrameCapture() noexcept {
+	destroy();
+}
+
+GLPP_DECL
+void FrameCapture::init(ThreadPool& pool, unsigned buffers) noexcept {
+	destroy();
+
+	mPool = &pool;
+	for(unsigned i = 0; i < buffers; i++)
+		mSlots.emplace_back();
+}
+
+GLPP_DECL
+void FrameCapture::destroy() noexcept {
+	for(Slot& slot : mSlots)
+		while(slot.state.load(std::memory_order_acquire) == kHandling)
+			std::this_thread::yield();
+	mReading.clear();
+	mSlots.clear(); // Unmaps before the buffers go away, see Slot's member order
+	mPool   = nullptr;
+	mFrames = 0;
+	mStats  = {};
+}
+
+GLPP_DECL
+bool FrameCapture::capture(
+	FramebufferView framebuffer,
+	GLint x, GLint y, GLsizei width, GLsizei height,
+	UnsizedImageFormat format, BasicType type, Callback callback)
+{
+	// Before acquire(), creating a buffer unbinds the PIXEL_PACK_BUFFER
+	GLint packBuffer = 0;
+	glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &packBuffer);
+
+	size_t bytes = size_t(width) * height * componentCount(format) * sizeOf(type);
+	Slot*  slot  = acquire(bytes);
+	if(!slot) return false;
+
+	GLint readFramebuffer = 0, packAlignment = 0;
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+	glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->buffer);
+	glReadnPixels(x, y, width, height, format, type, GLsizei(bytes), nullptr);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, GLuint(packBuffer));
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, GLuint(readFramebuffer));
+	glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+
+	issued(*slot, width, height, format, type, bytes, std::move(callback));
+	return true;
+}
+
+GLPP_DECL
+bool FrameCapture::capture(
+	unsigned texture, GLint level,
+	GLint x, GLint y, GLint layer, GLsizei width, GLsizei height,
+	UnsizedImageFormat format, BasicType type, Callback callback)
+{
+	GLint packBuffer = 0; // See above
+	glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &packBuffer);
+
+	size_t bytes = size_t(width) * height * componentCount(format) * sizeOf(type);
+	Slot*  slot  = acquire(bytes);
+	if(!slot) return false;
+
+	GLint packAlignment = 0;
+	glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->buffer);
+	glGetTextureSubImage(texture, level, x, y, layer, width, height, 1, format, type, GLsizei(bytes), nullptr);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, GLuint(packBuffer));
+	glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+
+	issued(*slot, width, height, format, type, bytes, std::move(callback));
+	return true;
+}
+
+GLPP_DECL
+auto FrameCapture::acquire(size_t bytes) noexcept
+	-> Slot*
+{
+	for(Slot& slot : mSlots) {
+		if(slot.state.load(std::memory_order_acquire) != kFree) continue;
+
+		if(slot.capacity < bytes) {
+			// Grows for bigger captures, stays mapped for the rest of its life otherwise
+			slot.mapping.reset();
+			slot.buffer.init();
+			slot.buffer.storage(STORAGE_MAP_READ_BIT | STORAGE_MAP_PERSISTENT_BIT | STORAGE_MAP_COHERENT_BIT, bytes);
+			slot.mapping  = slot.buffer.map(0, bytes, MAP_READ_BIT | MAP_PERSISTENT_BIT | MAP_COHERENT_BIT);
+			slot.capacity = bytes;
+		}
+		return &slot;
+	}
+	mStats.dropped++;
+	return nullptr;
+}
+
+GLPP_DECL
+void FrameCapture::issued(Slot& slot, GLsizei width, GLsizei height, UnsizedImageFormat format, BasicType type, size_t bytes, Callback&& callback) noexcept {
+	slot.sync     = fence();
+	slot.frame    = { slot.mapping.get(), bytes, width, height, format, type, mFrames++ };
+	slot.callback = std::move(callback);
+	slot.state.store(kReading, std::memory_order_relaxed);
+	mReading.push_back(&slot);
+
+	mStats.captures++;
+	mStats.bytes += bytes;
+}
+
+GLPP_DECL
+void FrameCapture::dispatch(Slot& slot) {
+	slot.sync.reset();
+	slot.state.store(kHandling, std::memory_order_relaxed);
+	mPool->push([&slot] {
+		slot.callback(slot.frame);
+		slot.callback = nullptr;
+		slot.state.store(kFree, std::memory_order_release);
+	});
+}
+
+GLPP_DECL
+size_t FrameCapture::update() noexcept {
+	size_t dispatched = 0;
+	// The GPU finishes reads in order, the first unfinished one means the rest aren't done either
+	while(!mReading.empty() && mReading.front()->sync.waitClient(0)) {
+		dispatch(*mReading.front());
+		mReading.pop_front();
+		dispatched++;
+	}
+	return dispatched;
+}
+
+GLPP_DECL
+void FrameCapture::finish() noexcept {
+	for(Slot* slot : mReading) {
+		(void) slot->sync.waitClient();
+		dispatch(*slot);
+	}
+	mReading.clear();
+	for(Slot& slot : mSlots)
+		while(slot.state.load(std::memory_order_acquire) == kHandling)
+			std::this_thread::yield();
+}
+
+GLPP_DECL
+size_t FrameCapture::pending() const noexcept {
+	size_t result = 0;
+	for(Slot const& slot : mSlots)
+		result += slot.state.load(std::memory_order_relaxed) != kFree;
+	return result;
+}
+
+} // namespace gl
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Buffer.hpp"
+#include "Enums.hpp"
+#include "Framebuffer.hpp"
+#include "Sync.hpp"
+#include "Texture.hpp"
+
+#include <GL/glew.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+namespace gl {
+
+class ThreadPool;
+
+/// Reads framebuffers and textures back without waiting for the GPU. capture() reads into one of a few persistently mapped
+/// PIXEL_PACK_BUFFERs and fences it, update() hands every finished read to a worker of `pool`, which gets the pixels straight out of the mapping.
+///
+///     gl::FrameCapture capture(pool);
+///     ...
+///     capture.capture(gl::FramebufferView::DefaultFramebuffer(), 0, 0, width, height, gl::RGBA, gl::UNSIGNED_BYTE, [](gl::FrameCapture::Frame const& frame) {
+///         encode(frame.pixels, frame.width, frame.height); // On a worker
+///     });
+///     capture.update(); // Once per frame on the GL thread
+///
+/// When all buffers are still being read or encoded capture() drops the frame instead of stalling, make more buffers if that happens.
+/// capture() leaves the PIXEL_PACK_BUFFER binding, GL_PACK_ALIGNMENT and the read framebuffer as they were.
+class FrameCapture {
+	struct Slot;
+public:
+	struct Stats {
+		size_t captures = 0; // Reads issued
+		size_t dropped  = 0; // capture() calls that found no free buffer
+		size_t bytes    = 0; // Bytes read back
+	};
+
+	/// Tightly packed rows (GL_PACK_ALIGNMENT 1), bottom row first like GL reads them
+	struct Frame {
+		void const*        pixels;
+		size_t             bytes;
+		GLsizei            width, height;
+		UnsizedImageFormat format;
+		BasicType          type;
+		uint64_t           index;  // Counts captures, tells dropped frames apart
+	};
+	/// Runs on a worker, `frame.pixels` is only valid during the call
+	using Callback = std::function<void(Frame const& frame)>;
+
+	FrameCapture(std::nullptr_t) noexcept;
+	explicit FrameCapture(ThreadPool& pool, unsigned buffers = 3) noexcept;
+	~FrameCapture() noexcept;
+
+	FrameCapture(FrameCapture&& other) noexcept = delete;
+	FrameCapture& operator=(FrameCapture&& other) noexcept = delete;
+	FrameCapture(FrameCapture const& other) = delete;
+	FrameCapture& operator=(FrameCapture const& other) = delete;
+
+	void init(ThreadPool& pool, unsigned buffers = 3) noexcept;
+	/// Waits for captures that are already being handed to callbacks, drops the ones the GPU didn't finish yet
+	void destroy() noexcept;
+
+	/// GL thread. Reads a region of `framebuffer`'s read buffer, false if the frame was dropped.
+	bool capture(
+		FramebufferView framebuffer,
+		GLint x, GLint y, GLsizei width, GLsizei height,
+		UnsizedImageFormat format, BasicType type, Callback callback);
+	/// GL thread. Reads a region of one level of a texture (one layer for arrays, one face for cubemaps)
+	bool capture(
+		unsigned texture, GLint level,
+		GLint x, GLint y, GLint layer, GLsizei width, GLsizei height,
+		UnsizedImageFormat format, BasicType type, Callback callback);
+
+	/// GL thread. Passes finished reads to the pool in capture order without waiting for the rest, returns how many
+	size_t update() noexcept;
+	/// GL thread. Waits for the GPU and the callbacks of every capture so far, e.g. before exiting
+	void finish() noexcept;
+
+	/// Captures the GPU or a callback is still working on
+	size_t pending() const noexcept;
+	Stats const& stats() const noexcept { return mStats; }
+
+private:
+	enum SlotState : uint8_t {
+		kFree,
+		kReading,  // Waiting for the GPU
+		kHandling, // A worker runs the callback
+	};
+	struct Slot {
+		PixelPackBuffer         buffer = nullptr;
+		detail::BufferMapping<> mapping;
+		size_t                  capacity = 0;
+		Frame                   frame;
+		Callback                callback;
+		Sync                    sync;
+		std::atomic<SlotState>  state { kFree };
+	};
+
+	ThreadPool*       mPool = nullptr;
+	std::deque<Slot>  mSlots;   // References stay valid while workers read them
+	std::deque<Slot*> mReading; // In capture order
+	uint64_t          mFrames = 0;
+	Stats             mStats;
+
+	// A free slot with room for `bytes`, nullptr if there is none
+	Slot* acquire(size_t bytes) noexcept;
+	void  issued(Slot& slot, GLsizei width, GLsizei height, UnsizedImageFormat format, BasicType type, size_t bytes, Callback&& callback) noexcept;
+	void  dispatch(Slot& slot);
+};
+
+} // namespace gl
@@ -1,5 +1,6 @@
 #include "Framebuffer.hpp"
 
+#include <cassert>
 #include <utility>
 #include <stdexcept>
 
@@ -159,7 +160,11 @@ Renderbuffer::Renderbuffer(unsigned samples, SizedImageFormat fmt, unsigned widt
 
 GLPP_DECL
 Renderbuffer::Renderbuffer(Renderbuffer&& other) noexcept :
-	mHandle(std::exchange(other.mHandle, 0))
+	mHandle(std::exchange(other.mHandle, 0)),
+	mFormat(std::exchange(other.mFormat, {})),
+	mWidth(std::exchange(other.mWidth, 0)),
+	mHeight(std::exchange(other.mHeight, 0)),
+	mSamples(std::exchange(other.mSamples, 0))
 {}
 
 GLPP_DECL
@@ -167,19 +172,70 @@ Renderbuffer& Renderbuffer::operator=(Renderbuffer&& other) noexcept {
 	if(mHandle) {
 		glDeleteRenderbuffers(1, &mHandle);
 	}
-	mHandle = std::exchange(other.mHandle, 0);
+	mHandle  = std::exchange(other.mHandle, 0);
+	mFormat  = std::exchange(other.mFormat, {});
+	mWidth   = std::exchange(other.mWidth, 0);
+	mHeight  = std::exchange(other.mHeight, 0);
+	mSamples = std::exchange(other.mSamples, 0);
 	return *this;
 }
 
 GLPP_DECL
 void Renderbuffer::storage(SizedImageFormat fmt, unsigned width, unsigned height) noexcept {
 	glNamedRenderbufferStorage(mHandle, fmt, width, height);
+	mFormat  = fmt;
+	mWidth   = width;
+	mHeight  = height;
+	mSamples = 0;
 }
 GLPP_DECL
 void Renderbuffer::storage(unsigned samples, SizedImageFormat fmt, unsigned width, unsigned height) noexcept {
 	glNamedRenderbufferStorageMultisample(mHandle, samples, fmt, width, height);
+	mFormat  = fmt;
+	mWidth   = width;
+	mHeight  = height;
+	mSamples = samples;
+}
+
+namespace detail {
+
+GLPP_DECL
+GLint renderbufferParameter(unsigned renderbuffer, GLenum parameter) noexcept {
+	GLint result = 0;
+	glGetNamedRenderbufferParameteriv(renderbuffer, parameter, &result);
+	return result;
 }
 
+} // namespace detail
+
+#define GLPP_CHECK_RENDERBUFFER_SHADOW(VALUE, PARAMETER) \
+	assert((mHandle == 0 || GLint(VALUE) == detail::renderbufferParameter(mHandle, PARAMETER)) && "Shadowed renderbuffer state is out of date, was it modified through its raw handle?")
+
+GLPP_DECL
+SizedImageFormat Renderbuffer::format() const noexcept {
+	// The driver reports GL_RGBA before storage() was called
+	GLPP_CHECK_RENDERBUFFER_SHADOW(mFormat ? GLenum(mFormat) : GLenum(GL_RGBA), GL_RENDERBUFFER_INTERNAL_FORMAT);
+	return mFormat;
+}
+GLPP_DECL
+unsigned Renderbuffer::width() const noexcept {
+	GLPP_CHECK_RENDERBUFFER_SHADOW(mWidth, GL_RENDERBUFFER_WIDTH);
+	return mWidth;
+}
+GLPP_DECL
+unsigned Renderbuffer::height() const noexcept {
+	GLPP_CHECK_RENDERBUFFER_SHADOW(mHeight, GL_RENDERBUFFER_HEIGHT);
+	return mHeight;
+}
+GLPP_DECL
+unsigned Renderbuffer::samples() const noexcept {
+	// The driver is allowed to round the sample count up
+	assert((mHandle == 0 || GLint(mSamples) <= detail::renderbufferParameter(mHandle, GL_RENDERBUFFER_SAMPLES)) && "Shadowed renderbuffer state is out of date, was it modified through its raw handle?");
+	return mSamples;
+}
+
+#undef GLPP_CHECK_RENDERBUFFER_SHADOW
+
 GLPP_DECL
 void Renderbuffer::debugLabel(std::string_view s) noexcept {
 	glObjectLabel(GL_RENDERBUFFER, mHandle, s.size(), s.data());
@@ -84,7 +84,11 @@ public:
 };
 
 class Renderbuffer {
-	unsigned mHandle = 0;
+	unsigned         mHandle  = 0;
+	SizedImageFormat mFormat  = {};
+	unsigned         mWidth   = 0;
+	unsigned         mHeight  = 0;
+	unsigned         mSamples = 0;
 public:
 	Renderbuffer() noexcept;
 	~Renderbuffer() noexcept;
@@ -105,6 +109,12 @@ public:
 	void storage(SizedImageFormat fmt, unsigned width, unsigned height) noexcept;
 	void storage(unsigned samples, SizedImageFormat fmt, unsigned width, unsigned height) noexcept;
 
+	// Getters: Remembered from storage(), debug builds compare them against the driver
+	SizedImageFormat format()  const noexcept;
+	unsigned         width()   const noexcept;
+	unsigned         height()  const noexcept;
+	unsigned         samples() const noexcept; // As requested, the driver may have rounded it up
+
 	operator unsigned() noexcept { return mHandle; }
 
 	void debugLabel(std::string_view s) noexcept;
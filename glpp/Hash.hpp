@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#ifdef __cpp_consteval
+	#define GLPP_CONSTEVAL consteval
+#else
+	#define GLPP_CONSTEVAL constexpr
+#endif
+
+namespace gl {
+
+/// 32 bit FNV-1a, usable at compile time
+constexpr uint32_t fnv1a(std::string_view s) noexcept {
+	uint32_t hash = 2166136261u;
+	for(char c : s) {
+		hash ^= uint8_t(c);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/// 64 bit FNV-1a, pass the previous result as `hash` to hash several strings in a row
+constexpr uint64_t fnv1a64(std::string_view s, uint64_t hash = 14695981039346656037ull) noexcept {
+	for(char c : s) {
+		hash ^= uint8_t(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+/// A uniform name together with its hash. Create with the "name"_u literal so the hashing happens at compile time.
+struct UniformName {
+	uint32_t    hash;
+	const char* name; // Compared against the cached name on a hit, has to be null terminated
+
+	constexpr UniformName(const char* name, size_t length) noexcept :
+		hash(fnv1a({ name, length })), name(name)
+	{}
+};
+
+inline namespace literals {
+
+GLPP_CONSTEVAL UniformName operator""_u(const char* name, size_t length) noexcept {
+	return UniformName(name, length);
+}
+
+} // inline namespace literals
+
+} // namespace gl
@@ -0,0 +1,39 @@
+#include "Layout.hpp"
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+namespace layout::detail {
+
+GLPP_DECL
+bool checkBlockLayout(ProgramReflection const& reflection, std::string_view blockName, std::vector<Entry> const& entries, size_t size) noexcept {
+	bool storage = false;
+	ProgramBlock const* block = reflection.uniformBlock(blockName);
+	if(!block) {
+		block   = reflection.storageBlock(blockName);
+		storage = true;
+	}
+	if(!block) return false;
+
+	if(size > size_t(block->dataSize)) return false;
+
+	for(uint32_t member : reflection.members(*block)) {
+		ProgramVariable const& var = storage ? reflection.bufferVariables()[member] : reflection.uniforms()[member];
+		auto entry = std::find_if(entries.begin(), entries.end(), [&](Entry const& e) { return e.offset == size_t(var.offset); });
+		if(entry == entries.end()      ||
+		   entry->type != var.type     ||
+		   entry->arrayStride  != var.arrayStride ||
+		   entry->matrixStride != var.matrixStride)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace layout::detail
+
+} // namespace gl
@@ -0,0 +1,334 @@
+#pragma once
+
+#include "ProgramReflection.hpp"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gl {
+
+enum BlockLayout {
+	STD140, // Uniform blocks
+	STD430  // Shader storage blocks
+};
+
+/// Describes the contents of a uniform or shader storage block as C++ types, so std140/std430 offsets are known at compile time
+/// and values can be written straight into mapped buffer memory:
+///
+///     using Light  = gl::layout::Struct<gl::layout::vec3, float, gl::layout::vec4>;
+///     using Lights = gl::layout::Struct<uint32_t, gl::layout::Array<Light, 16>>;
+///
+///     auto lights = gl::layout::Ref<Lights, gl::STD140>(region.data);
+///     lights.get<0>() = 2u;
+///     lights.get<1>()[0].assign(position, radius, color);
+///
+///     assert(gl::layout::check<Lights, gl::STD140>(program.reflection(), "Lights"));
+namespace layout {
+
+/// Scalars are float, int32_t, uint32_t and double (GLSL bools are uint32_t)
+template<class T, unsigned N> struct Vec {};
+/// Column major, Cols columns of Vec<T, Rows>
+template<class T, unsigned Cols, unsigned Rows = Cols> struct Mat {};
+/// N = 0 is a runtime sized array, only allowed as the last member of a storage block
+template<class Element, size_t N = 0> struct Array {};
+template<class... Members> struct Struct {};
+
+using vec2  = Vec<float, 2>;    using vec3  = Vec<float, 3>;    using vec4  = Vec<float, 4>;
+using ivec2 = Vec<int32_t, 2>;  using ivec3 = Vec<int32_t, 3>;  using ivec4 = Vec<int32_t, 4>;
+using uvec2 = Vec<uint32_t, 2>; using uvec3 = Vec<uint32_t, 3>; using uvec4 = Vec<uint32_t, 4>;
+using dvec2 = Vec<double, 2>;   using dvec3 = Vec<double, 3>;   using dvec4 = Vec<double, 4>;
+using mat2  = Mat<float, 2>;    using mat3  = Mat<float, 3>;    using mat4  = Mat<float, 4>;
+using mat2x3 = Mat<float, 2, 3>; using mat2x4 = Mat<float, 2, 4>;
+using mat3x2 = Mat<float, 3, 2>; using mat3x4 = Mat<float, 3, 4>;
+using mat4x2 = Mat<float, 4, 2>; using mat4x3 = Mat<float, 4, 3>;
+
+/// One basic member as glGetProgramResourceiv reports it, for comparing against reflection
+struct Entry {
+	size_t offset;
+	GLenum type;
+	GLint  arrayStride;
+	GLint  matrixStride;
+};
+
+namespace detail {
+
+constexpr size_t roundUp(size_t x, size_t alignment) noexcept { return (x + alignment - 1) / alignment * alignment; }
+
+template<class T>
+constexpr GLenum glType(unsigned cols, unsigned rows) noexcept {
+	if constexpr(std::is_same_v<T, float>) {
+		if(cols == 1) {
+			GLenum const vectors[] = { GL_FLOAT, GL_FLOAT_VEC2, GL_FLOAT_VEC3, GL_FLOAT_VEC4 };
+			return vectors[rows - 1];
+		}
+		GLenum const matrices[3][3] = {
+			{ GL_FLOAT_MAT2,   GL_FLOAT_MAT2x3, GL_FLOAT_MAT2x4 },
+			{ GL_FLOAT_MAT3x2, GL_FLOAT_MAT3,   GL_FLOAT_MAT3x4 },
+			{ GL_FLOAT_MAT4x2, GL_FLOAT_MAT4x3, GL_FLOAT_MAT4   },
+		};
+		return matrices[cols - 2][rows - 2];
+	}
+	else if constexpr(std::is_same_v<T, double>) {
+		if(cols == 1) {
+			GLenum const vectors[] = { GL_DOUBLE, GL_DOUBLE_VEC2, GL_DOUBLE_VEC3, GL_DOUBLE_VEC4 };
+			return vectors[rows - 1];
+		}
+		GLenum const matrices[3][3] = {
+			{ GL_DOUBLE_MAT2,   GL_DOUBLE_MAT2x3, GL_DOUBLE_MAT2x4 },
+			{ GL_DOUBLE_MAT3x2, GL_DOUBLE_MAT3,   GL_DOUBLE_MAT3x4 },
+			{ GL_DOUBLE_MAT4x2, GL_DOUBLE_MAT4x3, GL_DOUBLE_MAT4   },
+		};
+		return matrices[cols - 2][rows - 2];
+	}
+	else if constexpr(std::is_same_v<T, int32_t>) {
+		GLenum const vectors[] = { GL_INT, GL_INT_VEC2, GL_INT_VEC3, GL_INT_VEC4 };
+		return vectors[rows - 1];
+	}
+	else {
+		static_assert(std::is_same_v<T, uint32_t>, "Scalars have to be float, double, int32_t or uint32_t");
+		GLenum const vectors[] = { GL_UNSIGNED_INT, GL_UNSIGNED_INT_VEC2, GL_UNSIGNED_INT_VEC3, GL_UNSIGNED_INT_VEC4 };
+		return vectors[rows - 1];
+	}
+}
+
+/// size, alignment and (for arrays) stride of a description, plus flatten() to list its basic members
+template<class Desc, BlockLayout L> struct Traits;
+
+// Scalars
+template<class T, BlockLayout L>
+struct Traits {
+	using Scalar = T;
+	constexpr static unsigned components = 1;
+	constexpr static size_t   alignment  = sizeof(T);
+	constexpr static size_t   size       = sizeof(T);
+	constexpr static bool     basic      = true;
+	constexpr static GLenum   type       = glType<T>(1, 1);
+
+	static void flatten(std::vector<Entry>& out, size_t offset) { out.push_back({ offset, type, 0, 0 }); }
+};
+
+template<class T, unsigned N, BlockLayout L>
+struct Traits<Vec<T, N>, L> {
+	static_assert(N >= 1 && N <= 4);
+	using Scalar = T;
+	constexpr static unsigned components = N;
+	constexpr static size_t   alignment  = sizeof(T) * (N == 3 ? 4 : N);
+	constexpr static size_t   size       = sizeof(T) * N;
+	constexpr static bool     basic      = true;
+	constexpr static GLenum   type       = glType<T>(1, N);
+
+	static void flatten(std::vector<Entry>& out, size_t offset) { out.push_back({ offset, type, 0, 0 }); }
+};
+
+template<class T, unsigned Cols, unsigned Rows, BlockLayout L>
+struct Traits<Mat<T, Cols, Rows>, L> {
+	static_assert(Cols >= 2 && Cols <= 4 && Rows >= 2 && Rows <= 4);
+	using Scalar = T;
+	constexpr static size_t stride    = L == STD140 ? roundUp(Traits<Vec<T, Rows>, L>::alignment, 16) : Traits<Vec<T, Rows>, L>::alignment; // Between columns
+	constexpr static size_t alignment = stride;
+	constexpr static size_t size      = stride * Cols;
+	constexpr static bool   basic     = true;
+	constexpr static GLenum type      = glType<T>(Cols, Rows);
+
+	static void flatten(std::vector<Entry>& out, size_t offset) { out.push_back({ offset, type, 0, GLint(stride) }); }
+};
+
+template<class E, size_t N, BlockLayout L>
+struct Traits<Array<E, N>, L> {
+	constexpr static size_t stride    = L == STD140 ? roundUp(roundUp(Traits<E, L>::size, Traits<E, L>::alignment), 16) : roundUp(Traits<E, L>::size, Traits<E, L>::alignment);
+	constexpr static size_t alignment = L == STD140 ? roundUp(Traits<E, L>::alignment, 16) : Traits<E, L>::alignment;
+	constexpr static size_t size      = stride * N;
+	constexpr static bool   basic     = false;
+
+	// Arrays of basic types are reported once with their stride, others element by element (only the first of runtime sized ones)
+	static void flatten(std::vector<Entry>& out, size_t offset) {
+		if constexpr(Traits<E, L>::basic) {
+			size_t first = out.size();
+			Traits<E, L>::flatten(out, offset);
+			out[first].arrayStride = GLint(stride);
+		}
+		else {
+			for(size_t i = 0; i < (N == 0 ? 1 : N); i++)
+				Traits<E, L>::flatten(out, offset + i * stride);
+		}
+	}
+};
+
+template<class... M, BlockLayout L>
+struct Traits<Struct<M...>, L> {
+	constexpr static std::array<size_t, sizeof...(M)> computeOffsets() noexcept {
+		std::array<size_t, sizeof...(M)> result = {};
+		size_t offset = 0, i = 0;
+		((offset = roundUp(offset, Traits<M, L>::alignment), result[i++] = offset, offset += Traits<M, L>::size), ...);
+		return result;
+	}
+	constexpr static size_t computeEnd() noexcept {
+		size_t offset = 0;
+		((offset = roundUp(offset, Traits<M, L>::alignment) + Traits<M, L>::size), ...);
+		return offset;
+	}
+	constexpr static size_t computeAlignment() noexcept {
+		size_t alignment = 1;
+		((alignment = std::max(alignment, Traits<M, L>::alignment)), ...);
+		return L == STD140 ? roundUp(alignment, 16) : alignment;
+	}
+
+	constexpr static std::array<size_t, sizeof...(M)> offsets = computeOffsets();
+	constexpr static size_t alignment = computeAlignment();
+	constexpr static size_t size      = roundUp(computeEnd(), alignment);
+	constexpr static bool   basic     = false;
+
+	static void flatten(std::vector<Entry>& out, size_t offset) {
+		size_t i = 0;
+		(Traits<M, L>::flatten(out, offset + offsets[i++]), ...);
+	}
+};
+
+template<class Desc, BlockLayout L>
+struct TrailingStride { constexpr static size_t value = 0; };
+template<class E, BlockLayout L>
+struct TrailingStride<Array<E, 0>, L> { constexpr static size_t value = Traits<Array<E, 0>, L>::stride; };
+template<class... M, BlockLayout L>
+struct TrailingStride<Struct<M...>, L> {
+	using Last = std::tuple_element_t<sizeof...(M) - 1, std::tuple<M...>>;
+	constexpr static size_t value = TrailingStride<Last, L>::value;
+};
+
+bool checkBlockLayout(ProgramReflection const& reflection, std::string_view blockName, std::vector<Entry> const& entries, size_t size) noexcept;
+
+} // namespace detail
+
+/// Bytes taken up by `Desc`, plus `trailingElements` elements of a runtime sized array at its end
+template<class Desc, BlockLayout L>
+constexpr size_t size(size_t trailingElements = 0) noexcept { return detail::Traits<Desc, L>::size + trailingElements * detail::TrailingStride<Desc, L>::value; }
+template<class Desc, BlockLayout L>
+constexpr size_t alignment = detail::Traits<Desc, L>::alignment;
+/// Byte offset of member I of a Struct
+template<class Desc, size_t I, BlockLayout L>
+constexpr size_t offset = detail::Traits<Desc, L>::offsets[I];
+/// Distance between elements of an Array
+template<class Desc, BlockLayout L>
+constexpr size_t stride = detail::Traits<Desc, L>::stride;
+
+/// A typed pointer into mapped memory laid out according to `Desc`. Assigning to it writes the bytes right away.
+template<class Desc, BlockLayout L>
+class Ref {
+	uint8_t* mData;
+public:
+	using Traits = detail::Traits<Desc, L>;
+	using Scalar = typename Traits::Scalar;
+
+	explicit Ref(void* data) noexcept : mData(static_cast<uint8_t*>(data)) {}
+
+	/// Scalars convert, anything else has to be exactly as big as the vector (e.g. glm::vec3 or std::array<float, 3> for a vec3)
+	template<class V>
+	Ref const& operator=(V const& value) const noexcept {
+		if constexpr(Traits::components == 1 && std::is_arithmetic_v<V>) {
+			Scalar s = static_cast<Scalar>(value);
+			std::memcpy(mData, &s, sizeof(s));
+		}
+		else {
+			static_assert(std::is_trivially_copyable_v<V> && sizeof(V) == Traits::size, "Value doesn't match the size of the vector");
+			std::memcpy(mData, &value, sizeof(V));
+		}
+		return *this;
+	}
+
+	void* data() const noexcept { return mData; }
+};
+
+template<class T, unsigned Cols, unsigned Rows, BlockLayout L>
+class Ref<Mat<T, Cols, Rows>, L> {
+	uint8_t* mData;
+public:
+	using Traits = detail::Traits<Mat<T, Cols, Rows>, L>;
+
+	explicit Ref(void* data) noexcept : mData(static_cast<uint8_t*>(data)) {}
+
+	/// Takes tightly packed, column major matrices like glm's (e.g. glm::mat3 or float[9] for a mat3)
+	template<class V>
+	Ref const& operator=(V const& value) const noexcept {
+		static_assert(std::is_trivially_copyable_v<V> && sizeof(V) == sizeof(T) * Cols * Rows, "Value doesn't match the size of the matrix");
+		auto const* columns = reinterpret_cast<uint8_t const*>(&value);
+		for(unsigned c = 0; c < Cols; c++)
+			std::memcpy(mData + c * Traits::stride, columns + c * Rows * sizeof(T), Rows * sizeof(T));
+		return *this;
+	}
+
+	void* data() const noexcept { return mData; }
+};
+
+template<class E, size_t N, BlockLayout L>
+class Ref<Array<E, N>, L> {
+	uint8_t* mData;
+public:
+	using Traits = detail::Traits<Array<E, N>, L>;
+
+	explicit Ref(void* data) noexcept : mData(static_cast<uint8_t*>(data)) {}
+
+	Ref<E, L> operator[](size_t i) const noexcept {
+		assert((N == 0 || i < N) && "Array index out of range");
+		return Ref<E, L>(mData + i * Traits::stride);
+	}
+
+	/// Writes all elements of `values`
+	template<class ContainerT>
+	void assign(ContainerT const& values) const noexcept {
+		size_t i = 0;
+		for(auto const& value : values)
+			(*this)[i++] = value;
+	}
+
+	void* data() const noexcept { return mData; }
+};
+
+template<class... M, BlockLayout L>
+class Ref<Struct<M...>, L> {
+	uint8_t* mData;
+
+	template<size_t... I, class... V>
+	void assign(std::index_sequence<I...>, V const&... values) const noexcept { ((get<I>() = values), ...); }
+public:
+	using Traits = detail::Traits<Struct<M...>, L>;
+
+	explicit Ref(void* data) noexcept : mData(static_cast<uint8_t*>(data)) {}
+
+	template<size_t I>
+	auto get() const noexcept {
+		using Member = std::tuple_element_t<I, std::tuple<M...>>;
+		return Ref<Member, L>(mData + Traits::offsets[I]);
+	}
+
+	/// Writes the first sizeof...(V) members
+	template<class... V>
+	void assign(V const&... values) const noexcept {
+		static_assert(sizeof...(V) <= sizeof...(M), "More values than members");
+		assign(std::index_sequence_for<V...>(), values...);
+	}
+
+	void* data() const noexcept { return mData; }
+};
+
+/// Whether `Desc` matches the offsets, types and strides the driver reports for the block called `blockName`. Meant for assert().
+/// Only active members are compared, so this can't catch members missing at the end of a block.
+template<class Desc, BlockLayout L>
+bool check(ProgramReflection const& reflection, std::string_view blockName) noexcept {
+	std::vector<Entry> entries;
+	detail::Traits<Desc, L>::flatten(entries, 0);
+	return detail::checkBlockLayout(reflection, blockName, entries, size<Desc, L>());
+}
+
+} // namespace layout
+
+} // namespace gl
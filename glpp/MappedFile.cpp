@@ -0,0 +1,77 @@
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+namespace detail {
+
+GLPP_DECL
+bool MappedFile::open(char const* path) noexcept {
+	close();
+	#ifdef _WIN32
+		mFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if(mFile == INVALID_HANDLE_VALUE) {
+			mFile = nullptr;
+			return false;
+		}
+		LARGE_INTEGER size;
+		if(!GetFileSizeEx(mFile, &size) || size.QuadPart == 0) {
+			close();
+			return false;
+		}
+		mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		mData    = mMapping ? MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if(!mData) {
+			close();
+			return false;
+		}
+		mSize = size_t(size.QuadPart);
+	#else
+		int fd = ::open(path, O_RDONLY);
+		if(fd < 0) return false;
+		struct stat info;
+		if(fstat(fd, &info) != 0 || info.st_size == 0) {
+			::close(fd);
+			return false;
+		}
+		void* data = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd); // The mapping keeps the file alive
+		if(data == MAP_FAILED) return false;
+		mData = data;
+		mSize = size_t(info.st_size);
+	#endif
+	return true;
+}
+
+GLPP_DECL
+void MappedFile::close() noexcept {
+	#ifdef _WIN32
+		if(mData)    UnmapViewOfFile(mData);
+		if(mMapping) CloseHandle(mMapping);
+		if(mFile)    CloseHandle(mFile);
+		mMapping = mFile = nullptr;
+	#else
+		if(mData) munmap(const_cast<void*>(mData), mSize);
+	#endif
+	mData = nullptr;
+	mSize = 0;
+}
+
+} // namespace detail
+
+} // namespace gl
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gl {
+
+namespace detail {
+
+/// A whole file mapped read only, empty if it doesn't exist
+class MappedFile {
+	void const* mData = nullptr;
+	size_t      mSize = 0;
+	#ifdef _WIN32
+		void*   mFile    = nullptr;
+		void*   mMapping = nullptr;
+	#endif
+public:
+	MappedFile() noexcept = default;
+	explicit MappedFile(char const* path) noexcept { open(path); }
+	~MappedFile() noexcept { close(); }
+
+	MappedFile(MappedFile&& other) noexcept = delete;
+	MappedFile& operator=(MappedFile&& other) noexcept = delete;
+	MappedFile(MappedFile const& other) = delete;
+	MappedFile& operator=(MappedFile const& other) = delete;
+
+	bool open(char const* path) noexcept;
+	void close() noexcept;
+
+	uint8_t const* data() const noexcept { return static_cast<uint8_t const*>(mData); }
+	size_t         size() const noexcept { return mSize; }
+};
+
+} // namespace detail
+
+} // namespace gl
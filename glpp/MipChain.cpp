@@ -0,0 +1,340 @@
+#include "MipChain.hpp"
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define GLPP_MIP_SSE2
+#endif
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+namespace detail {
+
+// Which source texels each texel of the smaller level is made of, along one axis
+constexpr float kPi = 3.14159265358979f;
+
+struct MipAxis {
+	int                taps = 0;  // Per destination texel, unused taps have weight 0
+	std::vector<int>   indices;   // destination × taps, clamped to the source
+	std::vector<float> weights;   // destination × taps, sum to 1 per destination texel
+};
+
+GLPP_DECL
+float besselI0(float x) noexcept {
+	// Power series, converges quickly for the small arguments of a Kaiser window
+	float sum = 1, term = 1;
+	for(int k = 1; k < 32 && term > sum * 1e-7f; k++) {
+		float factor = x / (2.f * k);
+		term *= factor * factor;
+		sum  += term;
+	}
+	return sum;
+}
+
+GLPP_DECL
+MipAxis mipAxis(GLsizei src, GLsizei dst, MipOptions const& options) {
+	MipAxis axis;
+	float scale = float(src) / float(dst);
+
+	// Source space support of each destination texel
+	float radius = options.filter == MIP_FILTER_BOX ? scale * 0.5f : options.kaiserRadius * scale;
+	axis.taps = int(std::ceil(radius * 2)) + 1;
+	axis.indices.resize(size_t(dst) * axis.taps);
+	axis.weights.resize(size_t(dst) * axis.taps);
+
+	float windowNorm = 1.f / besselI0(options.kaiserAlpha);
+	for(GLsizei i = 0; i < dst; i++) {
+		float center = (float(i) + 0.5f) * scale; // In continuous source coordinates, texel j covers [j, j+1)
+		int   first  = int(std::floor(center - radius));
+		float sum    = 0;
+		for(int t = 0; t < axis.taps; t++) {
+			int   j = first + t;
+			float w = 0;
+			if(options.filter == MIP_FILTER_BOX) {
+				// Overlap of texel j with the box
+				w = std::max(0.f, std::min(float(j + 1), center + radius) - std::max(float(j), center - radius));
+			}
+			else {
+				float x = (float(j) + 0.5f - center) / scale; // In destination texels
+				float r = x / options.kaiserRadius;
+				if(r > -1.f && r < 1.f) {
+					float sinc   = x == 0 ? 1.f : std::sin(kPi * x) / (kPi * x);
+					float window = besselI0(options.kaiserAlpha * std::sqrt(1.f - r * r)) * windowNorm;
+					w = sinc * window;
+				}
+			}
+			axis.indices[size_t(i) * axis.taps + t] = std::clamp(j, 0, int(src) - 1);
+			axis.weights[size_t(i) * axis.taps + t] = w;
+			sum += w;
+		}
+		for(int t = 0; t < axis.taps; t++)
+			axis.weights[size_t(i) * axis.taps + t] /= sum;
+	}
+	return axis;
+}
+
+GLPP_DECL
+float srgbToLinear(float c) noexcept {
+	return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+GLPP_DECL
+float linearToSrgb(float c) noexcept {
+	return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.f / 2.4f) - 0.055f;
+}
+
+// 8 bit decoding, and the linear values half way between neighbouring sRGB codes for encoding with exact rounding
+struct SrgbTables {
+	float   decode[2][256]; // Linear, sRGB
+	float   midpoints[256]; // The last one is past 1 so the search below always stops
+	uint8_t encode[4096];   // Starting guess for encoding, off by at most one near black
+
+	SrgbTables() noexcept {
+		for(int i = 0; i < 256; i++) {
+			decode[0][i] = float(i) / 255.f;
+			decode[1][i] = srgbToLinear(float(i) / 255.f);
+			midpoints[i] = i < 255 ? srgbToLinear((float(i) + 0.5f) / 255.f) : 2.f;
+		}
+		for(int i = 0; i < 4096; i++)
+			encode[i] = uint8_t(linearToSrgb(float(i) / 4095.f) * 255.f + 0.5f);
+	}
+
+	uint8_t encodeSrgb(float v) const noexcept {
+		int code = encode[int(v * 4095.f + 0.5f)];
+		while(code > 0 && v < midpoints[code - 1]) code--;
+		while(v >= midpoints[code]) code++;
+		return uint8_t(code);
+	}
+};
+GLPP_DECL
+SrgbTables const& srgbTables() noexcept {
+	static SrgbTables const tables;
+	return tables;
+}
+
+// Converts a row of texels to float, `srgbMask` has a bit for each channel that is sRGB encoded
+GLPP_DECL
+void decodeMipRow(void const* src, float* dst, size_t count, unsigned channels, BasicType type, unsigned srgbMask) noexcept {
+	switch(type) {
+	case UNSIGNED_BYTE: {
+		uint8_t const* s = static_cast<uint8_t const*>(src);
+		float const* tables[4];
+		for(unsigned c = 0; c < channels; c++)
+			tables[c] = srgbTables().decode[srgbMask >> c & 1];
+		for(size_t x = 0; x < count; x++, s += channels, dst += channels)
+			for(unsigned c = 0; c < channels; c++)
+				dst[c] = tables[c][s[c]];
+		break;
+	}
+	case UNSIGNED_SHORT: {
+		uint16_t const* s = static_cast<uint16_t const*>(src);
+		for(size_t x = 0; x < count; x++, s += channels, dst += channels) {
+			for(unsigned c = 0; c < channels; c++) {
+				float v = float(s[c]) * (1.f / 65535.f);
+				dst[c] = srgbMask >> c & 1 ? srgbToLinear(v) : v;
+			}
+		}
+		break;
+	}
+	default:
+		std::memcpy(dst, src, count * channels * sizeof(float));
+		break;
+	}
+}
+
+GLPP_DECL
+void encodeMipRow(float const* src, void* dst, size_t count, unsigned channels, BasicType type, unsigned srgbMask) noexcept {
+	switch(type) {
+	case UNSIGNED_BYTE: {
+		uint8_t* d = static_cast<uint8_t*>(dst);
+		SrgbTables const& tables = srgbTables();
+		for(size_t x = 0; x < count; x++, src += channels, d += channels) {
+			for(unsigned c = 0; c < channels; c++) {
+				float v = std::clamp(src[c], 0.f, 1.f);
+				d[c] = srgbMask >> c & 1 ? tables.encodeSrgb(v) : uint8_t(v * 255.f + 0.5f);
+			}
+		}
+		break;
+	}
+	case UNSIGNED_SHORT: {
+		uint16_t* d = static_cast<uint16_t*>(dst);
+		for(size_t x = 0; x < count; x++, src += channels, d += channels) {
+			for(unsigned c = 0; c < channels; c++) {
+				float v = std::clamp(src[c], 0.f, 1.f);
+				if(srgbMask >> c & 1) v = linearToSrgb(v);
+				d[c] = uint16_t(v * 65535.f + 0.5f);
+			}
+		}
+		break;
+	}
+	default:
+		std::memcpy(dst, src, count * channels * sizeof(float));
+		break;
+	}
+}
+
+// dst[x] = Σ weights × src[indices] along a row, for each texel of the row
+GLPP_DECL
+void filterMipRow(float const* src, float* dst, MipAxis const& axis, size_t count, unsigned channels) noexcept {
+	int const*   indices = axis.indices.data();
+	float const* weights = axis.weights.data();
+	#ifdef GLPP_MIP_SSE2
+		if(channels == 4) {
+			for(size_t x = 0; x < count; x++, indices += axis.taps, weights += axis.taps) {
+				__m128 sum = _mm_setzero_ps();
+				for(int t = 0; t < axis.taps; t++)
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[t]), _mm_loadu_ps(src + size_t(indices[t]) * 4)));
+				_mm_storeu_ps(dst + x * 4, sum);
+			}
+			return;
+		}
+	#endif
+	for(size_t x = 0; x < count; x++, indices += axis.taps, weights += axis.taps) {
+		for(unsigned c = 0; c < channels; c++) {
+			float sum = 0;
+			for(int t = 0; t < axis.taps; t++)
+				sum += weights[t] * src[size_t(indices[t]) * channels + c];
+			dst[x * channels + c] = sum;
+		}
+	}
+}
+
+// dst = Σ weights[t] × rows[t], `values` floats each
+GLPP_DECL
+void blendMipRows(float const* const* rows, float const* weights, int count, float* dst, size_t values) noexcept {
+	size_t i = 0;
+	#ifdef GLPP_MIP_SSE2
+		for(; i + 4 <= values; i += 4) {
+			__m128 sum = _mm_setzero_ps();
+			for(int t = 0; t < count; t++)
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[t]), _mm_loadu_ps(rows[t] + i)));
+			_mm_storeu_ps(dst + i, sum);
+		}
+	#endif
+	for(; i < values; i++) {
+		float sum = 0;
+		for(int t = 0; t < count; t++)
+			sum += weights[t] * rows[t][i];
+		dst[i] = sum;
+	}
+}
+
+} // namespace detail
+
+GLPP_DECL
+void MipChain::build(GLsizei width, GLsizei height, UnsizedImageFormat format, BasicType type, void const* pixels, MipOptions const& options, ThreadPool* pool) {
+	assert((type == UNSIGNED_BYTE || type == UNSIGNED_SHORT || type == FLOAT) && "MipChain supports 8 bit, 16 bit and float texels");
+	assert(width > 0 && height > 0);
+
+	clear();
+	mFormat = format;
+	mType   = type;
+
+	unsigned channels   = componentCount(format);
+	size_t   texelBytes = channels * sizeOf(type);
+	unsigned srgbMask   = 0;
+	if(options.srgb && type != FLOAT) {
+		srgbMask = (1u << channels) - 1;
+		if(channels == 4) srgbMask &= ~(1u << 3); // Alpha
+	}
+
+	GLsizei levels = 1;
+	while(std::max(width, height) >> levels) levels++;
+	if(options.levels > 0) levels = std::min(levels, options.levels);
+
+	size_t total = 0;
+	for(GLsizei level = 0; level < levels; level++) {
+		Level l;
+		l.width  = std::max(width  >> level, 1);
+		l.height = std::max(height >> level, 1);
+		l.offset = total;
+		l.bytes  = size_t(l.width) * l.height * texelBytes;
+		mLevels.push_back(l);
+		total += l.bytes;
+	}
+	mData.resize(total);
+	std::memcpy(mData.data(), pixels, mLevels[0].bytes);
+
+	auto parallel = [pool](size_t count, size_t rowValues, std::function<void(size_t, size_t)> const& fn) {
+		size_t grain = std::max<size_t>(1, 16384 / std::max<size_t>(rowValues, 1));
+		if(pool) pool->parallelFor(count, fn, grain);
+		else     fn(0, count);
+	};
+
+	// Each level is filtered from the float version of the previous one
+	std::vector<float> source(size_t(width) * height * channels);
+	parallel(height, size_t(width) * channels, [&](size_t begin, size_t end) {
+		for(size_t y = begin; y < end; y++)
+			detail::decodeMipRow(static_cast<uint8_t const*>(pixels) + y * width * texelBytes, &source[y * width * channels], width, channels, type, srgbMask);
+	});
+
+	std::vector<float> horizontal, target;
+	for(GLsizei level = 1; level < levels; level++) {
+		Level const& from = mLevels[level - 1];
+		Level const& to   = mLevels[level];
+		size_t fromRow = size_t(from.width) * channels;
+		size_t toRow   = size_t(to.width) * channels;
+
+		detail::MipAxis columns = detail::mipAxis(from.width,  to.width,  options);
+		detail::MipAxis rows    = detail::mipAxis(from.height, to.height, options);
+
+		horizontal.resize(size_t(from.height) * toRow);
+		parallel(from.height, fromRow, [&](size_t begin, size_t end) {
+			for(size_t y = begin; y < end; y++)
+				detail::filterMipRow(&source[y * fromRow], &horizontal[y * toRow], columns, to.width, channels);
+		});
+
+		target.resize(size_t(to.height) * toRow);
+		uint8_t* output = mData.data() + to.offset;
+		parallel(to.height, toRow, [&](size_t begin, size_t end) {
+			std::vector<float const*> taps(rows.taps);
+			for(size_t y = begin; y < end; y++) {
+				for(int t = 0; t < rows.taps; t++)
+					taps[t] = &horizontal[size_t(rows.indices[y * rows.taps + t]) * toRow];
+				float* row = &target[y * toRow];
+				detail::blendMipRows(taps.data(), &rows.weights[y * rows.taps], rows.taps, row, toRow);
+				detail::encodeMipRow(row, output + y * to.width * texelBytes, to.width, channels, type, srgbMask);
+			}
+		});
+
+		std::swap(source, target);
+	}
+}
+
+GLPP_DECL
+void MipChain::clear() noexcept {
+	mLevels.clear();
+	mData.clear();
+}
+
+GLPP_DECL
+void MipChain::upload(TextureView2D texture, GLsizei firstLevel) const noexcept {
+	GLint unpackAlignment = 0;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for(GLsizei level = firstLevel; level < levels(); level++)
+		texture.texSubimage(level - firstLevel, 0, 0, width(level), height(level), mFormat, mType, data(level));
+	glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+}
+
+GLPP_DECL
+void MipChain::upload(TextureView2DArray texture, GLsizei layer, GLsizei firstLevel) const noexcept {
+	GLint unpackAlignment = 0;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for(GLsizei level = firstLevel; level < levels(); level++)
+		texture.texSubimage(level - firstLevel, 0, 0, layer, width(level), height(level), 1, mFormat, mType, data(level));
+	glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+}
+
+} // namespace gl
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Enums.hpp"
+#include "Texture.hpp"
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gl {
+
+class ThreadPool;
+
+enum MipFilter {
+	MIP_FILTER_BOX,    // Average of the covered texels, what glGenerateMipmap does
+	MIP_FILTER_KAISER, // Kaiser windowed sinc, keeps the smaller levels sharper
+};
+
+struct MipOptions {
+	MipFilter filter      = MIP_FILTER_BOX;
+	/// RGB is sRGB encoded (e.g. for SRGB8_ALPHA8), averaged in linear space. Alpha is always linear.
+	bool      srgb        = false;
+	/// 0 builds the full chain down to 1×1
+	GLsizei   levels      = 0;
+	/// Kaiser only: radius in texels of the smaller level, and the window's shape (bigger is smoother, less ringing)
+	float     kaiserRadius = 3.f;
+	float     kaiserAlpha  = 4.f;
+};
+
+/// Builds all mip levels of a 2D image on the CPU, to upload them with texStorage() and one texSubimage() per level
+/// instead of glGenerateMipmap on the GL thread. build() makes no GL calls and can run on any thread:
+///
+///     gl::MipChain chain;
+///     pool.push([&] { chain.build(w, h, gl::RGBA, gl::UNSIGNED_BYTE, pixels, { gl::MIP_FILTER_KAISER, true }, &pool); ready = true; });
+///     ...
+///     texture.texStorage(chain.levels(), gl::SRGB8_ALPHA8, chain.width(0), chain.height(0));
+///     chain.upload(texture);
+///
+/// Supports UNSIGNED_BYTE, UNSIGNED_SHORT (both normalized) and FLOAT pixels with 1-4 channels, rows are tightly packed.
+/// Filtering happens in float with SSE2 where available, each level is filtered from the previous one without rounding in between.
+class MipChain {
+public:
+	MipChain() noexcept = default;
+
+	/// `pool` spreads the rows of each level over its threads, nullptr runs on the calling thread only
+	void build(GLsizei width, GLsizei height, UnsizedImageFormat format, BasicType type, void const* pixels, MipOptions const& options = {}, ThreadPool* pool = nullptr);
+	void clear() noexcept;
+
+	GLsizei            levels()             const noexcept { return GLsizei(mLevels.size()); }
+	GLsizei            width (GLsizei level) const noexcept { return mLevels[level].width; }
+	GLsizei            height(GLsizei level) const noexcept { return mLevels[level].height; }
+	void const*        data  (GLsizei level) const noexcept { return mData.data() + mLevels[level].offset; }
+	size_t             bytes (GLsizei level) const noexcept { return mLevels[level].bytes; }
+	UnsizedImageFormat format()             const noexcept { return mFormat; }
+	BasicType          type()               const noexcept { return mType; }
+
+	/// texSubimage() of every level, starting at `firstLevel` of the chain. The texture's storage has to exist already.
+	void upload(TextureView2D texture, GLsizei firstLevel = 0) const noexcept;
+	/// Same for one layer of an array texture
+	void upload(TextureView2DArray texture, GLsizei layer, GLsizei firstLevel = 0) const noexcept;
+
+private:
+	struct Level {
+		GLsizei width, height;
+		size_t  offset, bytes;
+	};
+
+	std::vector<Level>   mLevels;
+	std::vector<uint8_t> mData;
+	UnsizedImageFormat   mFormat = RGBA;
+	BasicType            mType   = UNSIGNED_BYTE;
+};
+
+} // namespace gl
@@ -0,0 +1,194 @@
+#include "Pipeline.hpp"
+
+#include "Hash.hpp"
+#include "Program.hpp"
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+#include <utility>
+
+namespace gl {
+
+namespace detail {
+
+// Index of each stage in PipelineCache::Key
+constexpr ShaderType kPipelineStages[] = {
+	VERTEX_SHADER, TESS_CONTROL_SHADER, TESS_EVALUATION_SHADER, GEOMETRY_SHADER, FRAGMENT_SHADER, COMPUTE_SHADER
+};
+
+} // namespace detail
+
+GLPP_DECL
+ShaderStageBits stageBit(ShaderType type) noexcept {
+	switch(type) {
+		case VERTEX_SHADER:          return VERTEX_SHADER_BIT;
+		case FRAGMENT_SHADER:        return FRAGMENT_SHADER_BIT;
+		case GEOMETRY_SHADER:        return GEOMETRY_SHADER_BIT;
+		case TESS_CONTROL_SHADER:    return TESS_CONTROL_SHADER_BIT;
+		case TESS_EVALUATION_SHADER: return TESS_EVALUATION_SHADER_BIT;
+		case COMPUTE_SHADER:         return COMPUTE_SHADER_BIT;
+	}
+	return ShaderStageBits(0);
+}
+
+GLPP_DECL
+Pipeline::Pipeline(std::nullptr_t) noexcept :
+	mHandle(0)
+{}
+
+GLPP_DECL
+Pipeline::Pipeline() noexcept :
+	mHandle(0)
+{
+	init();
+}
+
+GLPP_DECL
+Pipeline::~Pipeline() noexcept {
+	destroy();
+}
+
+GLPP_DECL
+Pipeline::Pipeline(std::initializer_list<Stage> stages) noexcept :
+	Pipeline()
+{
+	useStages(stages);
+}
+
+GLPP_DECL
+Pipeline::Pipeline(Pipeline&& other) noexcept :
+	mHandle(std::exchange(other.mHandle, 0))
+{}
+
+GLPP_DECL
+Pipeline& Pipeline::operator=(Pipeline&& other) noexcept {
+	destroy();
+	mHandle = std::exchange(other.mHandle, 0);
+	return *this;
+}
+
+GLPP_DECL
+void Pipeline::init() noexcept {
+	destroy();
+	glCreateProgramPipelines(1, &mHandle);
+}
+
+GLPP_DECL
+void Pipeline::destroy() noexcept {
+	if(mHandle) {
+		glDeleteProgramPipelines(1, &mHandle);
+		mHandle = 0;
+	}
+}
+
+GLPP_DECL
+void Pipeline::useStages(ShaderStageBits stages, unsigned program) noexcept {
+	glUseProgramStages(mHandle, stages, program);
+}
+
+GLPP_DECL
+void Pipeline::useStages(std::initializer_list<Stage> stages) noexcept {
+	for(Stage const& stage : stages)
+		useStage(stage.type, stage.program);
+}
+
+GLPP_DECL
+unsigned Pipeline::program(ShaderType type) const noexcept {
+	GLint result = 0;
+	glGetProgramPipelineiv(mHandle, type, &result);
+	return unsigned(result);
+}
+
+GLPP_DECL
+void Pipeline::activeProgram(unsigned program) noexcept {
+	glActiveShaderProgram(mHandle, program);
+}
+
+GLPP_DECL
+void Pipeline::bind() const noexcept {
+	glBindProgramPipeline(mHandle);
+}
+
+GLPP_DECL
+void Pipeline::unbind() noexcept {
+	glBindProgramPipeline(0);
+}
+
+GLPP_DECL
+bool Pipeline::validate() const noexcept {
+	glValidateProgramPipeline(mHandle);
+	return validationStatus();
+}
+
+GLPP_DECL
+void Pipeline::assertValid() const {
+	if(!validate()) throw ValidationError(infoLog());
+}
+
+GLPP_DECL
+bool Pipeline::validationStatus() const noexcept {
+	GLint result;
+	glGetProgramPipelineiv(mHandle, GL_VALIDATE_STATUS, &result);
+	return result == GL_TRUE;
+}
+
+GLPP_DECL
+std::string Pipeline::infoLog() const noexcept {
+	GLint length = 0;
+	glGetProgramPipelineiv(mHandle, GL_INFO_LOG_LENGTH, &length);
+	std::string result(length, ' ');
+	GLsizei written = 0;
+	glGetProgramPipelineInfoLog(mHandle, length, &written, result.data());
+	result.resize(written);
+	return result;
+}
+
+GLPP_DECL
+void Pipeline::debugLabel(std::string_view name) noexcept {
+	glObjectLabel(GL_PROGRAM_PIPELINE, mHandle, name.length(), name.data());
+}
+
+GLPP_DECL
+Pipeline& PipelineCache::pipeline(std::initializer_list<Pipeline::Stage> stages) noexcept {
+	return pipeline(key(stages));
+}
+
+GLPP_DECL
+Pipeline& PipelineCache::pipeline(Key const& key) noexcept {
+	auto [iter, inserted] = mPipelines.try_emplace(key, nullptr);
+	if(inserted) {
+		iter->second.init();
+		for(size_t i = 0; i < key.size(); i++)
+			if(key[i]) iter->second.useStage(detail::kPipelineStages[i], key[i]);
+	}
+	return iter->second;
+}
+
+GLPP_DECL
+auto PipelineCache::key(std::initializer_list<Pipeline::Stage> stages) noexcept
+	-> Key
+{
+	Key result = {};
+	for(Pipeline::Stage const& stage : stages)
+		for(size_t i = 0; i < result.size(); i++)
+			if(detail::kPipelineStages[i] == stage.type) result[i] = stage.program;
+	return result;
+}
+
+GLPP_DECL
+void PipelineCache::erase(unsigned program) noexcept {
+	for(auto iter = mPipelines.begin(); iter != mPipelines.end();) {
+		bool uses = false;
+		for(unsigned p : iter->first) uses = uses || p == program;
+		iter = uses ? mPipelines.erase(iter) : std::next(iter);
+	}
+}
+
+GLPP_DECL
+size_t PipelineCache::KeyHash::operator()(Key const& key) const noexcept {
+	return size_t(fnv1a64({ reinterpret_cast<char const*>(key.data()), sizeof(Key) }));
+}
+
+} // namespace gl
@@ -1,19 +1,115 @@
 #pragma once
 
+#include "Enums.hpp"
+#include "Shader.hpp"
+
+#include <GL/glew.h>
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
 namespace gl {
 
-// TODO
+enum ShaderStageBits : GLbitfield {
+	VERTEX_SHADER_BIT          = GL_VERTEX_SHADER_BIT,
+	FRAGMENT_SHADER_BIT        = GL_FRAGMENT_SHADER_BIT,
+	GEOMETRY_SHADER_BIT        = GL_GEOMETRY_SHADER_BIT,
+	TESS_CONTROL_SHADER_BIT    = GL_TESS_CONTROL_SHADER_BIT,
+	TESS_EVALUATION_SHADER_BIT = GL_TESS_EVALUATION_SHADER_BIT,
+	COMPUTE_SHADER_BIT         = GL_COMPUTE_SHADER_BIT,
+	ALL_SHADER_BITS            = GL_ALL_SHADER_BITS
+};
+__GLPP_ENUM_BITFIELD_OPERATORS(ShaderStageBits)
+
+ShaderStageBits stageBit(ShaderType type) noexcept;
 
+/// Combines separable programs (see Program::separable()) per stage, so M vertex and N fragment programs
+/// take M+N links instead of M×N. Uniforms are set on the programs, through glProgramUniform* as usual.
+///
+///     gl::Pipeline pipeline = {
+///         { gl::VERTEX_SHADER,   skinnedVertex },
+///         { gl::FRAGMENT_SHADER, litFragment },
+///     };
+///     pipeline.bind();
+///
+/// A program bound with Program::use() takes precedence over the bound pipeline, call Program::unuse() first.
 class Pipeline {
 	unsigned mHandle;
 public:
+	struct Stage {
+		ShaderType type;
+		unsigned   program; // Linked with separable(), 0 to clear the stage
+	};
+
+	Pipeline(std::nullptr_t) noexcept;
 	Pipeline() noexcept;
 	~Pipeline() noexcept;
 
-	Pipeline(Pipeline&& other) noexcept                 = delete;
-	Pipeline& operator=(Pipeline&& other) noexcept      = delete;
+	Pipeline(std::initializer_list<Stage> stages) noexcept;
+
+	Pipeline(Pipeline&& other) noexcept;
+	Pipeline& operator=(Pipeline&& other) noexcept;
 	Pipeline(Pipeline const& other) noexcept            = delete;
 	Pipeline& operator=(Pipeline const& other) noexcept = delete;
+
+	void init() noexcept;
+	void destroy() noexcept;
+
+	/// Uses `program` for all of `stages`. Stages the program has no shader for are cleared.
+	void useStages(ShaderStageBits stages, unsigned program) noexcept;
+	void useStage(ShaderType type, unsigned program) noexcept { useStages(stageBit(type), program); }
+	void useStages(std::initializer_list<Stage> stages) noexcept;
+	/// The program currently used for `type`, 0 if none
+	unsigned program(ShaderType type) const noexcept;
+
+	/// The program glUniform* (instead of glProgramUniform*) calls go to while the pipeline is bound
+	void activeProgram(unsigned program) noexcept;
+
+	void bind() const noexcept;
+	static void unbind() noexcept;
+
+	/// Checks whether the stages' interfaces match and the pipeline can be drawn with in the current state
+	bool validate() const noexcept;
+	void assertValid() const;
+	bool validationStatus() const noexcept;
+	std::string infoLog() const noexcept;
+
+	void debugLabel(std::string_view name) noexcept;
+
+	operator unsigned() const noexcept { return mHandle; }
+};
+
+/// Creates each combination of programs once, e.g. for materials that pick their vertex and fragment program independently.
+///
+///     cache.pipeline({ { gl::VERTEX_SHADER, mesh.vertexProgram }, { gl::FRAGMENT_SHADER, material.program } }).bind();
+///
+/// Pipelines are keyed by the program handles, erase() a program's pipelines before deleting it,
+/// or the handle may be reused by a new program and pick up the stale pipelines.
+class PipelineCache {
+public:
+	/// One program handle per stage, in the order of detail::kPipelineStages
+	using Key = std::array<unsigned, 6>;
+
+	PipelineCache() noexcept = default;
+
+	/// Creates the pipeline on the first call, later calls with the same programs return the same one
+	Pipeline& pipeline(std::initializer_list<Pipeline::Stage> stages) noexcept;
+	Pipeline& pipeline(Key const& key) noexcept;
+	static Key key(std::initializer_list<Pipeline::Stage> stages) noexcept;
+
+	/// Destroys all pipelines using `program`
+	void erase(unsigned program) noexcept;
+	void clear() noexcept { mPipelines.clear(); }
+
+	size_t size() const noexcept { return mPipelines.size(); }
+
+private:
+	struct KeyHash { size_t operator()(Key const& key) const noexcept; };
+	std::unordered_map<Key, Pipeline, KeyHash> mPipelines;
 };
 
-} // namespace gl
\ No newline at end of file
+} // namespace gl
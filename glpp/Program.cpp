@@ -1,6 +1,7 @@
 #include "Program.hpp"
 
 #include <algorithm>
+#include <cstring>
 
 #ifndef GLPP_DECL
 	#define GLPP_DECL
@@ -34,14 +35,22 @@ Program::Program(std::initializer_list<unsigned> shaders) :
 
 GLPP_DECL
 Program::Program(Program&& other) noexcept :
-	mHandle(other.mHandle)
+	mHandle(other.mHandle),
+	mReflection(std::move(other.mReflection)),
+	mUniformCache(std::move(other.mUniformCache)),
+	mUniformNames(std::move(other.mUniformNames)),
+	mUniformTypes(std::move(other.mUniformTypes))
 {
 	other.mHandle = 0;
 }
 GLPP_DECL
 Program& Program::operator=(Program&& other) noexcept {
 	reset();
-	mHandle = std::exchange(other.mHandle, 0);
+	mHandle       = std::exchange(other.mHandle, 0);
+	mReflection   = std::move(other.mReflection);
+	mUniformCache = std::move(other.mUniformCache);
+	mUniformNames = std::move(other.mUniformNames);
+	mUniformTypes = std::move(other.mUniformTypes);
 	return *this;
 }
 
@@ -57,6 +66,10 @@ void Program::reset() noexcept {
 		glDeleteProgram(mHandle);
 		mHandle = 0;
 	}
+	mReflection.clear();
+	mUniformCache.clear();
+	mUniformNames.clear();
+	mUniformTypes.clear();
 }
 
 GLPP_DECL
@@ -85,7 +98,33 @@ void Program::detach(std::initializer_list<unsigned> shaders) noexcept {
 GLPP_DECL
 bool Program::link() noexcept {
 	glLinkProgram(mHandle);
-	return linkStatus();
+	return linked();
+}
+GLPP_DECL
+void Program::startLink() noexcept {
+	glLinkProgram(mHandle);
+}
+GLPP_DECL
+bool Program::completionStatus() const noexcept {
+	if(!GLEW_KHR_parallel_shader_compile && !GLEW_ARB_parallel_shader_compile) return true;
+	GLint result;
+	glGetProgramiv(mHandle, GL_COMPLETION_STATUS_KHR, &result);
+	return result == GL_TRUE;
+}
+GLPP_DECL
+bool Program::linked() noexcept {
+	bool success = linkStatus();
+	if(success) {
+		mReflection.build(mHandle);
+		buildUniformCache();
+	}
+	else {
+		mReflection.clear();
+		mUniformCache.clear();
+		mUniformNames.clear();
+		mUniformTypes.clear();
+	}
+	return success;
 }
 GLPP_DECL
 bool Program::link(std::initializer_list<unsigned> shaders) noexcept {
@@ -95,6 +134,23 @@ bool Program::link(std::initializer_list<unsigned> shaders) noexcept {
 	return success;
 }
 GLPP_DECL
+std::vector<uint8_t> Program::binary(GLenum& format) const {
+	GLint length = 0;
+	glGetProgramiv(mHandle, GL_PROGRAM_BINARY_LENGTH, &length);
+	std::vector<uint8_t> result(length);
+	GLsizei written = 0;
+	format = GL_NONE;
+	if(length > 0)
+		glGetProgramBinary(mHandle, length, &written, &format, result.data());
+	result.resize(written);
+	return result;
+}
+GLPP_DECL
+bool Program::loadBinary(GLenum format, void const* data, size_t bytes) noexcept {
+	glProgramBinary(mHandle, format, data, GLsizei(bytes));
+	return linked();
+}
+GLPP_DECL
 void Program::assertLinked() const {
 	if(!linkStatus()) {
 		throw LinkerError("Failed linking shader program: " + infoLog());
@@ -117,39 +173,127 @@ void Program::use() const noexcept {
 	glUseProgram(mHandle);
 }
 
+GLPP_DECL
+void Program::unuse() noexcept {
+	glUseProgram(0);
+}
+
+GLPP_DECL
+void Program::buildUniformCache() noexcept {
+	struct Uniform {
+		std::string name;
+		int         location;
+		GLenum      type;
+	};
+	std::vector<Uniform> uniforms;
+
+	for(ProgramVariable const& u : mReflection.uniforms()) {
+		if(u.location < 0) continue; // Lives in a uniform block
+
+		std::string_view name = mReflection.name(u);
+		uniforms.push_back({ std::string(name), u.location, u.type });
+
+		// Arrays are reported as "name[0]", make "name" and the other elements findable as well
+		if(name.size() > 3 && name.substr(name.size() - 3) == "[0]") {
+			std::string_view base = name.substr(0, name.size() - 3);
+			uniforms.push_back({ std::string(base), u.location, u.type });
+			for(GLint element = 1; element < u.arraySize; element++) {
+				std::string elementName = std::string(base) + '[' + std::to_string(element) + ']';
+				int location = glGetUniformLocation(mHandle, elementName.c_str());
+				uniforms.push_back({ std::move(elementName), location, u.type });
+			}
+		}
+	}
+
+	size_t capacity = 8;
+	while(capacity < uniforms.size() * 2) capacity *= 2;
+	mUniformCache.assign(capacity, { 0, kUniformCacheEmpty, 0, 0 });
+	mUniformNames.clear();
+	mUniformTypes.clear();
+
+	for(Uniform const& u : uniforms) {
+		if(u.location >= 0) {
+			if(size_t(u.location) >= mUniformTypes.size()) mUniformTypes.resize(size_t(u.location) + 1, 0);
+			mUniformTypes[size_t(u.location)] = u.type;
+		}
+
+		uint32_t hash = fnv1a(u.name);
+		for(size_t i = hash & (capacity - 1);; i = (i + 1) & (capacity - 1)) {
+			UniformCacheEntry& entry = mUniformCache[i];
+			if(entry.location == kUniformCacheEmpty) {
+				entry = { hash, u.location, uint32_t(mUniformNames.size()), uint32_t(u.name.size()) };
+				mUniformNames += u.name;
+				break;
+			}
+			if(entry.hash == hash && std::string_view(mUniformNames).substr(entry.nameOffset, entry.nameLength) == u.name)
+				break; // Already there
+		}
+	}
+}
+
+GLPP_DECL
+int Program::uniformLocation(UniformName name) const noexcept {
+	if(mUniformCache.empty()) return glGetUniformLocation(mHandle, name.name); // Not linked through link()
+
+	size_t mask = mUniformCache.size() - 1;
+	for(size_t i = name.hash & mask;; i = (i + 1) & mask) {
+		UniformCacheEntry const& entry = mUniformCache[i];
+		if(entry.location == kUniformCacheEmpty) return -1;
+		if(entry.hash == name.hash &&
+		   std::strncmp(mUniformNames.data() + entry.nameOffset, name.name, entry.nameLength) == 0 &&
+		   name.name[entry.nameLength] == '\0')
+		{
+			return entry.location;
+		}
+	}
+}
 GLPP_DECL
 int Program::uniformLocation(const char* name) const noexcept {
-	return glGetUniformLocation(mHandle, name);
+	return uniformLocation(UniformName(name, std::strlen(name)));
+}
+template<class T> GLPP_DECL
+void Program::uniformScalar(int at, T value) noexcept {
+	GLenum declared = at >= 0 && size_t(at) < mUniformTypes.size() ? mUniformTypes[size_t(at)] : 0;
+	switch(declared) {
+	case 0:               detail::programUniform(mHandle, at, 1, &value); break; // Unknown, not linked through link()
+	case GL_FLOAT:        glProgramUniform1f (mHandle, at, GLfloat(value));  break;
+	case GL_DOUBLE:       glProgramUniform1d (mHandle, at, GLdouble(value)); break;
+	case GL_UNSIGNED_INT: glProgramUniform1ui(mHandle, at, GLuint(value));   break;
+	default:              glProgramUniform1i (mHandle, at, GLint(value));    break; // int, bool, samplers and images
+	}
 }
+template void Program::uniformScalar(int, int) noexcept;
+template void Program::uniformScalar(int, unsigned) noexcept;
+
 GLPP_DECL
 void Program::uniform(int at, float f) noexcept {
-	glUniform1f(at, f);
+	glProgramUniform1f(mHandle, at, f);
 }
 
 #ifdef GLPP_HAS_GLM
 	GLPP_DECL
 	void Program::uniform(int at, glm::vec2 const& v) noexcept {
-		glUniform2fv(at, 1, &((float const&)v));
+		glProgramUniform2fv(mHandle, at, 1, &((float const&)v));
 	}
 	GLPP_DECL
 	void Program::uniform(int at, glm::vec3 const& v) noexcept {
-		glUniform3fv(at, 1, &((float const&)v));
+		glProgramUniform3fv(mHandle, at, 1, &((float const&)v));
 	}
 	GLPP_DECL
 	void Program::uniform(int at, glm::vec4 const& v) noexcept {
-		glUniform4fv(at, 1, &((float const&)v));
+		glProgramUniform4fv(mHandle, at, 1, &((float const&)v));
 	}
 	GLPP_DECL
 	void Program::uniform(int at, glm::mat3x3 const& m) noexcept {
-		glUniformMatrix3fv(at, 1, GL_FALSE, &((float const&)m));
+		glProgramUniformMatrix3fv(mHandle, at, 1, GL_FALSE, &((float const&)m));
 	}
 	GLPP_DECL
 	void Program::uniform(int at, glm::mat4x3 const& m) noexcept {
-		glUniformMatrix4x3fv(at, 1, GL_FALSE, &((float const&)m));
+		glProgramUniformMatrix4x3fv(mHandle, at, 1, GL_FALSE, &((float const&)m));
 	}
 	GLPP_DECL
 	void Program::uniform(int at, glm::mat4x4 const& m) noexcept {
-		glUniformMatrix4fv(at, 1, GL_FALSE, &((float const&)m));
+		glProgramUniformMatrix4fv(mHandle, at, 1, GL_FALSE, &((float const&)m));
 	}
 #endif // defined(GLPP_HAS_GLM)
 
@@ -209,13 +353,13 @@ size_t Program::numAttachedShaders() const noexcept {
 GLPP_DECL
 size_t Program::numActiveAttributes() const noexcept {
 	GLint result;
-	glGetProgramiv(mHandle, GL_ATTACHED_SHADERS, &result);
+	glGetProgramiv(mHandle, GL_ACTIVE_ATTRIBUTES, &result);
 	return result;
 }
 GLPP_DECL
 size_t Program::longestActiveAttribute() const noexcept {
 	GLint result;
-	glGetProgramiv(mHandle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &result);
+	glGetProgramiv(mHandle, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &result);
 	return result;
 }
 GLPP_DECL
@@ -227,41 +371,11 @@ size_t Program::numActiveUniforms() const noexcept {
 
 GLPP_DECL
 int Program::attribLocation(const char* name) const noexcept {
+	if(ProgramVariable const* input = mReflection.input(name))
+		return input->location;
 	return glGetAttribLocation(mHandle, name);
 }
 
-/*
-GLint numBlocks = 0;
-glGetProgramInterfaceiv(prog, GL_UNIFORM_BLOCK, GL_ACTIVE_RESOURCES, &numBlocks);
-const GLenum blockProperties[1] = {GL_NUM_ACTIVE_VARIABLES};
-const GLenum activeUnifProp[1] = {GL_ACTIVE_VARIABLES};
-const GLenum unifProperties[3] = {GL_NAME_LENGTH​, GL_TYPE​, GL_LOCATION};
-
-for(int blockIx = 0; blockIx < numBlocks; ++blockIx)
-{
-  GLint numActiveUnifs = 0;
-  glGetProgramResourceiv(prog, GL_UNIFORM_BLOCK, blockIx, 1, blockProperties, 1, NULL, numActiveUnifs);
-
-  if(!numActiveUnifs)
-    continue;
-
-  std::vector<GLint> blockUnifs(numActiveUnifs);
-  glGetProgramResourceiv(prog, GL_UNIFORM_BLOCK, blockIx, 1, activeUnifProp, numActiveUnifs, NULL, &blockUnifs[0]);
-
-  for(int unifIx = 0; unifIx < numActiveUnifs; ++unifIx)
-  {
-    GLint values[3];
-    glGetProgramResourceiv(prog, GL_UNIFORM, blockUnifs[unifIx], 3, unifProperties, 3, NULL, values);
-
-    // Get the name. Must use a std::vector rather than a std::string for C++03 standards issues.
-    // C++11 would let you use a std::string directly.
-    std::vector<char> nameData(values[0]);
-    glGetProgramResourceName(prog, GL_UNIFORM, blockUnifs[unifIx], nameData.size(), NULL, &nameData[0]);
-    std::string name(nameData.begin(), nameData.end() - 1);
-  }
-}
-*/
-
 GLPP_DECL
 void Program::debugLabel(std::string_view name) noexcept {
 	glObjectLabel(GL_PROGRAM, mHandle, name.length(), name.data());
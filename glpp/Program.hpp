@@ -1,16 +1,17 @@
 #pragma once
 
+#include "Hash.hpp"
+#include "ProgramReflection.hpp"
+#include "Uniform.hpp"
+
+#include <cstring>
 #include <initializer_list>
 #include <string>
 #include <stdexcept>
+#include <vector>
 
 #include <GL/glew.h>
 
-#if __has_include(<glm/fwd.hpp>)
-#include <glm/fwd.hpp>
-#define GLPP_HAS_GLM
-#endif
-
 namespace gl {
 
 class ValidationError : public std::runtime_error {
@@ -28,7 +29,25 @@ public: using std::runtime_error::runtime_error;
 // TODO: incomplete
 
 class Program {
-	unsigned mHandle;
+	struct UniformCacheEntry {
+		uint32_t hash;
+		int      location;   // kUniformCacheEmpty or a location
+		uint32_t nameOffset; // Into mUniformNames, compared on a hit so names sharing a hash can't be mixed up
+		uint32_t nameLength;
+	};
+	constexpr static int kUniformCacheEmpty = -2;
+
+	unsigned                       mHandle;
+	ProgramReflection              mReflection;   // Built by link()
+	std::vector<UniformCacheEntry> mUniformCache; // Open addressing hash table, filled by link()
+	std::string                    mUniformNames; // Names of mUniformCache's entries, back to back
+	std::vector<GLenum>            mUniformTypes; // Declared type by location, filled by link()
+
+	void buildUniformCache() noexcept;
+	// Converts to the uniform's declared scalar type, see uniform(int, T)
+	template<class T> void uniformScalar(int at, T value) noexcept;
+	// Checks the link status and rebuilds mReflection and mUniformCache
+	bool linked() noexcept;
 public:
 	Program(std::nullptr_t) noexcept;
 	Program() noexcept;
@@ -51,20 +70,45 @@ public:
 	void detach(unsigned shader) noexcept;
 	[[nodiscard]] bool link() noexcept;
 	void assertLinked() const;
+	/// link() in two halves: glLinkProgram without waiting, and checking the result once completionStatus() says so. See also ProgramQueue.
+	void startLink() noexcept;
+	[[nodiscard]] bool finishLink() noexcept { return linked(); }
+	/// Whether linkStatus() would return without waiting (GL_COMPLETION_STATUS_KHR), always true without KHR_parallel_shader_compile
+	bool completionStatus() const noexcept;
 
 	void attach(std::initializer_list<unsigned> shaders) noexcept;
 	void detach(std::initializer_list<unsigned> shaders) noexcept;
 	[[nodiscard]] bool link  (std::initializer_list<unsigned> shaders) noexcept;
 
+	/// The driver specific binary of the linked program, call hintBinaryRetrievable() before link(). See also ProgramCache.
+	std::vector<uint8_t> binary(GLenum& format) const;
+	/// Loads what binary() returned. Fails if the driver can't use it (e.g. after an update), link from source in that case.
+	[[nodiscard]] bool loadBinary(GLenum format, void const* data, size_t bytes) noexcept;
+
 	bool validate() const noexcept;
 	void assertValid() const;
 
 	void use() const noexcept;
+	static void unuse() noexcept;
 
 	// Uniforms and stuff
+	/// Looked up in a table built from the active uniforms after link(), no driver calls. Names of arrays work with and without "[0]", elements like "uArray[3]" work as well.
+	int  uniformLocation(UniformName name) const noexcept;
+	/// Same as above, but hashes the name at runtime
 	int  uniformLocation(const char* name) const noexcept;
+	/// Set through glProgramUniform*, the program doesn't have to be bound
 	void uniform(int at, float f) noexcept;
-	// TODO: non-glm versions of uniforms
+	/// Converted to the declared type of the uniform like glUniform1f converts floats (e.g. uniform("uScale", 2) on a float uniform),
+	/// as long as the program was linked through link(). Otherwise uploaded as int or unsigned, which only works for uniforms of that type.
+	template<class T, std::enable_if_t<std::is_same_v<T, int> || std::is_same_v<T, unsigned>, int> = 0>
+	void uniform(int at, T value) noexcept { uniformScalar(at, value); }
+	template<class T, size_t N>
+	void uniform(int at, Vector<T, N> const& v) noexcept { detail::programUniform(mHandle, at, 1, &v); }
+	template<class T, size_t Cols, size_t Rows>
+	void uniform(int at, Matrix<T, Cols, Rows> const& m) noexcept { detail::programUniform(mHandle, at, 1, &m); }
+	/// Arrays, e.g. uniform(location, bones, boneCount)
+	template<class T>
+	void uniform(int at, T const* values, size_t count) noexcept { detail::programUniform(mHandle, at, GLsizei(count), values); }
 	#ifdef GLPP_HAS_GLM
 		void uniform(int at, glm::vec2 const& v) noexcept;
 		void uniform(int at, glm::vec3 const& v) noexcept;
@@ -79,6 +123,24 @@ public:
 		if(int u = uniformLocation(name); u >= 0)
 			uniform(u, std::forward<Arg0>(arg0), std::forward<Args>(args)...);
 	}
+	/// e.g. program.uniform("uModel"_u, model)
+	template<class Arg0, class... Args>
+	void uniform(UniformName name, Arg0&& arg0, Args&&... args) {
+		if(int u = uniformLocation(name); u >= 0)
+			uniform(u, std::forward<Arg0>(arg0), std::forward<Args>(args)...);
+	}
+
+	/// Resolves a uniform once, setting it through the handle skips values that didn't change:
+	///
+	///     auto uModel = program.uniformHandle<glm::mat4>("uModel"_u);
+	///     auto uBones = program.uniformHandle<glm::mat4[64]>("uBones"_u);
+	template<class T>
+	UniformHandle<T> uniformHandle(UniformName name) const noexcept {
+		if constexpr(std::is_array_v<T>) return { mHandle, uniformLocation(name), name.name };
+		else                             return { mHandle, uniformLocation(name) };
+	}
+	template<class T>
+	UniformHandle<T> uniformHandle(const char* name) const noexcept { return uniformHandle<T>(UniformName(name, std::strlen(name))); }
 
 	int  uniformBlockIndex(const char* name) noexcept;
 	void uniformBlockBinding(unsigned blockIndex, unsigned blockBinding) noexcept;
@@ -96,6 +158,8 @@ public:
 	size_t      numActiveUniforms() const noexcept;
 
 	// Reflection Queries
+	/// Everything about the active resources, as of the last successful link()
+	ProgramReflection const& reflection() const noexcept { return mReflection; }
 	int attribLocation(const char* name) const noexcept;
 
 	operator unsigned() noexcept { return mHandle; }
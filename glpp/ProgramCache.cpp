@@ -0,0 +1,254 @@
+#include "ProgramCache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+namespace detail {
+
+// Archive layout: ArchiveHeader, ProgramCache::Entry[count] sorted by key, binaries
+struct ArchiveHeader {
+	char     magic[8];
+	uint32_t version;
+	uint32_t count;
+	uint64_t driver;
+};
+constexpr char     kArchiveMagic[8] = { 'g', 'l', 'p', 'p', 'b', 'i', 'n', '\0' };
+constexpr uint32_t kArchiveVersion  = 1;
+
+} // namespace detail
+
+GLPP_DECL
+ProgramCache::ProgramCache(std::nullptr_t) noexcept {}
+
+GLPP_DECL
+ProgramCache::ProgramCache(std::string path) noexcept {
+	open(std::move(path));
+}
+
+GLPP_DECL
+void ProgramCache::open(std::string path) noexcept {
+	close();
+	mPath = std::move(path);
+
+	char const* renderer = reinterpret_cast<char const*>(glGetString(GL_RENDERER));
+	char const* version  = reinterpret_cast<char const*>(glGetString(GL_VERSION));
+	mDriver = fnv1a64(version ? version : "", fnv1a64(renderer ? renderer : ""));
+
+	map();
+}
+
+GLPP_DECL
+void ProgramCache::map() noexcept {
+	mEntries    = nullptr;
+	mEntryCount = 0;
+	if(!mFile.open(mPath.c_str())) return;
+
+	detail::ArchiveHeader header;
+	bool usable = mFile.size() >= sizeof(header);
+	if(usable) {
+		std::memcpy(&header, mFile.data(), sizeof(header));
+		usable =
+			std::memcmp(header.magic, detail::kArchiveMagic, sizeof(header.magic)) == 0 &&
+			header.version == detail::kArchiveVersion &&
+			header.driver  == mDriver &&
+			(mFile.size() - sizeof(header)) / sizeof(Entry) >= header.count;
+	}
+	if(!usable) {
+		mFile.close(); // Replaced by the next save()
+		return;
+	}
+
+	mEntries    = reinterpret_cast<Entry const*>(mFile.data() + sizeof(header));
+	mEntryCount = header.count;
+}
+
+GLPP_DECL
+bool ProgramCache::save() {
+	if(mAdded.empty()) return true;
+
+	// Merge the mapped entries with the added ones, both sorted by key
+	struct Source {
+		Entry          entry;
+		uint8_t const* data;
+	};
+	std::vector<Source> entries;
+	entries.reserve(mEntryCount + mAdded.size());
+	Entry const* mapped = mEntries;
+	Entry const* mappedEnd = mEntries + mEntryCount;
+	for(auto& [key, added] : mAdded) {
+		for(; mapped != mappedEnd && mapped->key < key; mapped++)
+			if(mapped->offset + mapped->size <= mFile.size())
+				entries.push_back({ *mapped, mFile.data() + mapped->offset });
+		if(mapped != mappedEnd && mapped->key == key) mapped++; // Replaced
+		entries.push_back({ { key, 0, uint32_t(added.binary.size()), added.format }, added.binary.data() });
+	}
+	for(; mapped != mappedEnd; mapped++)
+		if(mapped->offset + mapped->size <= mFile.size())
+			entries.push_back({ *mapped, mFile.data() + mapped->offset });
+
+	detail::ArchiveHeader header;
+	std::memcpy(header.magic, detail::kArchiveMagic, sizeof(header.magic));
+	header.version = detail::kArchiveVersion;
+	header.count   = uint32_t(entries.size());
+	header.driver  = mDriver;
+
+	uint64_t offset = sizeof(header) + entries.size() * sizeof(Entry);
+	for(Source& s : entries) {
+		s.entry.offset = offset;
+		offset += s.entry.size;
+	}
+
+	// Write next to the archive and swap it in, so a crash can't leave half an archive behind
+	std::string temporary = mPath + ".tmp";
+	std::FILE* file = std::fopen(temporary.c_str(), "wb");
+	if(!file) return false;
+	bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+	for(Source const& s : entries)
+		ok = ok && std::fwrite(&s.entry, sizeof(Entry), 1, file) == 1;
+	for(Source const& s : entries)
+		ok = ok && std::fwrite(s.data, 1, s.entry.size, file) == s.entry.size;
+	ok = std::fclose(file) == 0 && ok;
+
+	mEntries    = nullptr;
+	mEntryCount = 0;
+	mFile.close(); // Windows can't replace mapped files, entries' data is copied already
+
+	std::error_code error;
+	if(ok) std::filesystem::rename(temporary, mPath, error);
+	if(!ok || error) {
+		std::filesystem::remove(temporary, error);
+		map(); // mAdded stays for the next try
+		return false;
+	}
+
+	mAdded.clear();
+	map();
+	return true;
+}
+
+GLPP_DECL
+void ProgramCache::close() noexcept {
+	mEntries    = nullptr;
+	mEntryCount = 0;
+	mFile.close();
+	mAdded.clear();
+}
+
+GLPP_DECL
+uint64_t ProgramCache::key(std::initializer_list<Stage> stages, std::string_view defines) const noexcept {
+	// Lengths go in as well, so moving text from one source to the next changes the key
+	auto add = [](uint64_t hash, auto const& value) {
+		return fnv1a64({ reinterpret_cast<char const*>(&value), sizeof(value) }, hash);
+	};
+	uint64_t hash = mDriver;
+	for(Stage const& stage : stages) {
+		hash = add(hash, stage.type);
+		for(std::string_view source : stage.sources)
+			hash = fnv1a64(source, add(hash, uint64_t(source.size())));
+	}
+	return fnv1a64(defines, add(hash, uint64_t(defines.size())));
+}
+
+GLPP_DECL
+Program ProgramCache::program(std::initializer_list<Stage> stages, std::string_view defines) {
+	uint64_t key = this->key(stages, defines);
+
+	Program result;
+	if(load(key, result)) return result;
+	result.init(); // Start over in case a rejected binary left something behind
+
+	auto start = std::chrono::steady_clock::now();
+
+	std::vector<Shader> shaders;
+	shaders.reserve(stages.size());
+	for(Stage const& stage : stages) {
+		if(defines.empty())
+			shaders.emplace_back(stage.type, stage.sources);
+		else {
+			std::string source;
+			for(std::string_view part : stage.sources) source += part;
+			shaders.emplace_back(stage.type, source, defines);
+		}
+	}
+
+	result.hintBinaryRetrievable();
+	for(Shader& shader : shaders) result.attach(shader);
+	(void) result.link();
+	for(Shader& shader : shaders) result.detach(shader);
+	result.assertLinked();
+
+	mStats.buildTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	store(key, result);
+	return result;
+}
+
+GLPP_DECL
+bool ProgramCache::load(uint64_t key, Program& program) noexcept {
+	GLenum      format = GL_NONE;
+	void const* data   = nullptr;
+	size_t      size   = 0;
+	if(auto added = mAdded.find(key); added != mAdded.end()) {
+		format = added->second.format;
+		data   = added->second.binary.data();
+		size   = added->second.binary.size();
+	}
+	else if(Entry const* entry = find(key); entry && entry->offset + entry->size <= mFile.size()) {
+		format = entry->format;
+		data   = mFile.data() + entry->offset;
+		size   = entry->size;
+	}
+	else {
+		mStats.misses++;
+		return false;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	bool success = program.loadBinary(format, data, size);
+	mStats.loadTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if(success) {
+		mStats.hits++;
+	}
+	else {
+		mStats.rejected++;
+		mStats.misses++;
+	}
+	return success;
+}
+
+GLPP_DECL
+void ProgramCache::store(uint64_t key, Program const& program) {
+	Added added;
+	added.binary = program.binary(added.format);
+	if(added.binary.empty()) return; // Driver doesn't support binaries, or hintBinaryRetrievable() was missing
+	mAdded[key] = std::move(added);
+}
+
+GLPP_DECL
+size_t ProgramCache::size() const noexcept {
+	size_t result = mAdded.size();
+	for(size_t i = 0; i < mEntryCount; i++)
+		result += mAdded.count(mEntries[i].key) == 0;
+	return result;
+}
+
+GLPP_DECL
+auto ProgramCache::find(uint64_t key) const noexcept
+	-> Entry const*
+{
+	Entry const* last  = mEntries + mEntryCount;
+	Entry const* entry = std::lower_bound(mEntries, last, key, [](Entry const& e, uint64_t key) { return e.key < key; });
+	return entry != last && entry->key == key ? entry : nullptr;
+}
+
+} // namespace gl
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "MappedFile.hpp"
+#include "Program.hpp"
+#include "Shader.hpp"
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gl {
+
+/// Keeps the binaries of linked programs in a single file, so later runs skip compiling and linking.
+/// Entries are keyed by a hash of the shader sources, the defines and the GL_RENDERER and GL_VERSION strings.
+/// The file is memory mapped, an archive written by a different driver is ignored as a whole.
+/// If the driver rejects a binary anyway, the program is built from source and the entry replaced.
+///
+///     gl::ProgramCache cache("shaders.bin");
+///     gl::Program lit = cache.program({
+///         { gl::VERTEX_SHADER,   { vertexSource } },
+///         { gl::FRAGMENT_SHADER, { fragmentSource } },
+///     }, "#define SHADOWS 1\n");
+///     ...
+///     cache.save(); // Only writes if something changed
+class ProgramCache {
+public:
+	using Stage = ShaderStage;
+
+	struct Stats {
+		size_t hits      = 0;
+		size_t misses    = 0; // Including rejected
+		size_t rejected  = 0; // The binary was there, but the driver refused it
+		double loadTime  = 0; // Seconds spent loading binaries
+		double buildTime = 0; // Seconds spent compiling and linking on misses
+	};
+
+	ProgramCache(std::nullptr_t) noexcept;
+	/// Needs a current context, see open()
+	explicit ProgramCache(std::string path) noexcept;
+	~ProgramCache() noexcept = default;
+
+	ProgramCache(ProgramCache&& other) noexcept = delete;
+	ProgramCache& operator=(ProgramCache&& other) noexcept = delete;
+	ProgramCache(ProgramCache const& other) = delete;
+	ProgramCache& operator=(ProgramCache const& other) = delete;
+
+	/// Maps the archive at `path`, a missing or unusable file just starts an empty cache
+	void open(std::string path) noexcept;
+	/// Writes the archive if anything was added, returns false if writing failed
+	bool save();
+	void close() noexcept;
+
+	/// Hash of everything that ends up in the program, and of the driver
+	uint64_t key(std::initializer_list<Stage> stages, std::string_view defines = {}) const noexcept;
+
+	/// Loads the program from the cache, or builds it from source and adds it. Throws like Shader and Program::assertLinked() do.
+	Program program(std::initializer_list<Stage> stages, std::string_view defines = {});
+
+	/// The lower level parts of program(), for programs built differently
+	[[nodiscard]] bool load(uint64_t key, Program& program) noexcept;
+	/// `program` has to be linked with hintBinaryRetrievable()
+	void store(uint64_t key, Program const& program);
+
+	Stats const& stats() const noexcept { return mStats; }
+	size_t       size()  const noexcept;
+
+private:
+	struct Entry {
+		uint64_t key;
+		uint64_t offset; // Of the binary in the file
+		uint32_t size;
+		uint32_t format;
+	};
+	struct Added {
+		GLenum               format;
+		std::vector<uint8_t> binary;
+	};
+
+	std::string                 mPath;
+	uint64_t                    mDriver = 0; // Hash of GL_RENDERER and GL_VERSION
+	detail::MappedFile          mFile;
+	Entry const*                mEntries    = nullptr; // Into mFile, sorted by key
+	size_t                      mEntryCount = 0;
+	std::map<uint64_t, Added>   mAdded;      // Not saved yet, shadows mEntries
+	Stats                       mStats;
+
+	// Maps mPath and checks its header
+	void         map() noexcept;
+	Entry const* find(uint64_t key) const noexcept;
+};
+
+} // namespace gl
@@ -0,0 +1,100 @@
+#include "ProgramQueue.hpp"
+
+#include <cassert>
+#include <string>
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+GLPP_DECL
+ProgramQueue::ProgramQueue(unsigned compilerThreads) noexcept {
+	if(GLEW_KHR_parallel_shader_compile)
+		glMaxShaderCompilerThreadsKHR(compilerThreads);
+	else if(GLEW_ARB_parallel_shader_compile)
+		glMaxShaderCompilerThreadsARB(compilerThreads);
+}
+
+GLPP_DECL
+auto ProgramQueue::add(std::initializer_list<ShaderStage> stages, std::string_view defines)
+	-> Ticket
+{
+	Job& job = mJobs.emplace_back();
+	job.program.init();
+	job.shaders.reserve(stages.size());
+	for(ShaderStage const& stage : stages) {
+		Shader& shader = job.shaders.emplace_back(stage.type);
+		if(stage.sources.size() == 1)
+			shader.startCompileGLSL(*stage.sources.begin(), defines);
+		else {
+			std::string source;
+			for(std::string_view part : stage.sources) source += part;
+			shader.startCompileGLSL(source, defines);
+		}
+		job.program.attach(shader);
+	}
+	// Linking waits for the compiles on the driver's side, not here
+	job.program.startLink();
+	mWaiting++;
+	return mJobs.size() - 1;
+}
+
+GLPP_DECL
+auto ProgramQueue::add(Program&& program) noexcept
+	-> Ticket
+{
+	Job& job = mJobs.emplace_back();
+	job.program = std::move(program);
+	job.program.startLink();
+	mWaiting++;
+	return mJobs.size() - 1;
+}
+
+GLPP_DECL
+bool ProgramQueue::ready(Ticket ticket) noexcept {
+	assert(ticket < mJobs.size());
+	Job& job = mJobs[ticket];
+	if(!job.ready && !job.taken)
+		job.ready = job.program.completionStatus();
+	return job.ready;
+}
+
+GLPP_DECL
+size_t ProgramQueue::poll() noexcept {
+	size_t busy = 0;
+	for(Ticket ticket = mFirstBusy; ticket < mJobs.size(); ticket++) {
+		Job const& job = mJobs[ticket];
+		if(job.taken || ready(ticket)) {
+			if(busy == 0) mFirstBusy = ticket + 1;
+			continue;
+		}
+		busy++;
+	}
+	return busy;
+}
+
+GLPP_DECL
+Program ProgramQueue::take(Ticket ticket) {
+	assert(ticket < mJobs.size() && !mJobs[ticket].taken && "Every ticket can only be taken once");
+	Job job = std::move(mJobs[ticket]);
+	mJobs[ticket].taken = true;
+	mWaiting--;
+
+	if(!job.program.finishLink()) {
+		std::string log;
+		for(Shader& shader : job.shaders)
+			if(!shader.compileStatus())
+				log += "Failed compiling " + std::string(to_string(shader.shaderType())) + ":\n" + shader.infoLog();
+		if(!log.empty())
+			throw CompilerError(log);
+		throw LinkerError("Failed linking shader program: " + job.program.infoLog());
+	}
+
+	for(Shader& shader : job.shaders)
+		job.program.detach(shader);
+	return std::move(job.program);
+}
+
+} // namespace gl
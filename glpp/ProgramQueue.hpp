@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Program.hpp"
+#include "Shader.hpp"
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <initializer_list>
+#include <string_view>
+#include <vector>
+
+namespace gl {
+
+/// Builds many programs at once. add() only hands the sources to the driver, with KHR_parallel_shader_compile
+/// compiling and linking then happens on the driver's threads while the caller goes on.
+/// poll() and ready() check without blocking, info logs are only read for programs that failed.
+///
+///     gl::ProgramQueue queue;
+///     for(Material& m : materials)
+///         m.ticket = queue.add({ { gl::VERTEX_SHADER, { m.vertex } }, { gl::FRAGMENT_SHADER, { m.fragment } } }, m.defines);
+///     while(queue.poll() > 0)
+///         drawLoadingScreen();
+///     for(Material& m : materials)
+///         m.program = queue.take(m.ticket);
+///
+/// Without the extension everything still works, but take() is where the driver does the work.
+class ProgramQueue {
+public:
+	using Ticket = size_t;
+
+	/// `compilerThreads` goes to glMaxShaderCompilerThreadsKHR, the default lets the driver choose
+	explicit ProgramQueue(unsigned compilerThreads = 0xFFFFFFFF) noexcept;
+
+	ProgramQueue(ProgramQueue&& other) noexcept = default;
+	ProgramQueue& operator=(ProgramQueue&& other) noexcept = default;
+	ProgramQueue(ProgramQueue const& other) = delete;
+	ProgramQueue& operator=(ProgramQueue const& other) = delete;
+
+	/// Starts compiling the stages and linking them, `defines` are inserted after each stage's #version line
+	Ticket add(std::initializer_list<ShaderStage> stages, std::string_view defines = {});
+	/// Also starts linking `program`, with whatever is attached to it
+	Ticket add(Program&& program) noexcept;
+
+	/// Whether take() would return right away
+	bool   ready(Ticket ticket) noexcept;
+	/// Checks the programs that weren't ready yet, returns how many still aren't
+	size_t poll() noexcept;
+	/// Programs added and not taken yet
+	size_t size() const noexcept { return mWaiting; }
+
+	/// Takes the finished program, waiting for it if it isn't ready(). Every ticket can be taken once.
+	/// Throws CompilerError or LinkerError with the info logs if building failed.
+	Program take(Ticket ticket);
+
+private:
+	struct Job {
+		Program             program = nullptr;
+		std::vector<Shader> shaders;
+		bool                ready   = false;
+		bool                taken   = false;
+	};
+
+	std::vector<Job> mJobs;
+	size_t           mWaiting  = 0;
+	size_t           mFirstBusy = 0; // No job before it needs polling
+};
+
+} // namespace gl
@@ -0,0 +1,219 @@
+#include "ProgramReflection.hpp"
+
+#include <iterator>
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+namespace detail {
+
+GLPP_DECL
+GLint programInterfaceParameter(unsigned program, GLenum interface, GLenum parameter) noexcept {
+	GLint result = 0;
+	glGetProgramInterfaceiv(program, interface, parameter, &result);
+	return result;
+}
+
+// Queries `properties` of one resource, `values` has to have room for each of them
+template<size_t N> GLPP_DECL
+void programResource(unsigned program, GLenum interface, GLuint index, GLenum const (&properties)[N], GLint (&values)[N]) noexcept {
+	glGetProgramResourceiv(program, interface, index, N, properties, N, nullptr, values);
+}
+
+} // namespace detail
+
+GLPP_DECL
+void ProgramReflection::readName(unsigned program, GLenum interface, GLuint index, GLint length, uint32_t& offset, uint32_t& hash) {
+	offset = uint32_t(mNames.size());
+	mNames.resize(offset + length); // length includes the '\0'
+	GLsizei written = 0;
+	glGetProgramResourceName(program, interface, index, length, &written, mNames.data() + offset);
+	mNames.resize(offset + written + 1);
+	hash = fnv1a({ mNames.data() + offset, size_t(written) });
+}
+
+GLPP_DECL
+void ProgramReflection::build(unsigned program) {
+	clear();
+
+	// Uniforms
+	{
+		GLenum const properties[] = { GL_NAME_LENGTH, GL_TYPE, GL_ARRAY_SIZE, GL_LOCATION, GL_BLOCK_INDEX, GL_OFFSET, GL_ARRAY_STRIDE, GL_MATRIX_STRIDE, GL_IS_ROW_MAJOR };
+		GLint count = detail::programInterfaceParameter(program, GL_UNIFORM, GL_ACTIVE_RESOURCES);
+		mUniforms.reserve(count);
+		for(GLint i = 0; i < count; i++) {
+			GLint v[std::size(properties)];
+			detail::programResource(program, GL_UNIFORM, i, properties, v);
+			ProgramVariable& u = mUniforms.emplace_back();
+			readName(program, GL_UNIFORM, i, v[0], u.nameOffset, u.nameHash);
+			u.type                = v[1];
+			u.arraySize           = v[2];
+			u.location            = v[3];
+			u.locationIndex       = -1;
+			u.block               = v[4];
+			u.offset              = v[5];
+			u.arrayStride         = v[6];
+			u.matrixStride        = v[7];
+			u.rowMajor            = v[8];
+			u.topLevelArraySize   = -1;
+			u.topLevelArrayStride = -1;
+		}
+	}
+
+	// Buffer variables
+	{
+		GLenum const properties[] = { GL_NAME_LENGTH, GL_TYPE, GL_ARRAY_SIZE, GL_BLOCK_INDEX, GL_OFFSET, GL_ARRAY_STRIDE, GL_MATRIX_STRIDE, GL_IS_ROW_MAJOR, GL_TOP_LEVEL_ARRAY_SIZE, GL_TOP_LEVEL_ARRAY_STRIDE };
+		GLint count = detail::programInterfaceParameter(program, GL_BUFFER_VARIABLE, GL_ACTIVE_RESOURCES);
+		mBufferVariables.reserve(count);
+		for(GLint i = 0; i < count; i++) {
+			GLint v[std::size(properties)];
+			detail::programResource(program, GL_BUFFER_VARIABLE, i, properties, v);
+			ProgramVariable& b = mBufferVariables.emplace_back();
+			readName(program, GL_BUFFER_VARIABLE, i, v[0], b.nameOffset, b.nameHash);
+			b.type                = v[1];
+			b.arraySize           = v[2];
+			b.location            = -1;
+			b.locationIndex       = -1;
+			b.block               = v[3];
+			b.offset              = v[4];
+			b.arrayStride         = v[5];
+			b.matrixStride        = v[6];
+			b.rowMajor            = v[7];
+			b.topLevelArraySize   = v[8];
+			b.topLevelArrayStride = v[9];
+		}
+	}
+
+	// Vertex inputs and fragment outputs
+	for(GLenum interface : { GL_PROGRAM_INPUT, GL_PROGRAM_OUTPUT }) {
+		bool output = interface == GL_PROGRAM_OUTPUT;
+		std::vector<ProgramVariable>& variables = output ? mOutputs : mInputs;
+
+		GLenum const properties[] = { GL_NAME_LENGTH, GL_TYPE, GL_ARRAY_SIZE, GL_LOCATION };
+		GLint count = detail::programInterfaceParameter(program, interface, GL_ACTIVE_RESOURCES);
+		variables.reserve(count);
+		for(GLint i = 0; i < count; i++) {
+			GLint v[std::size(properties)];
+			detail::programResource(program, interface, i, properties, v);
+			ProgramVariable& var = variables.emplace_back();
+			readName(program, interface, i, v[0], var.nameOffset, var.nameHash);
+			var.type                = v[1];
+			var.arraySize           = v[2];
+			var.location            = v[3];
+			var.locationIndex       = -1;
+			var.block               = -1;
+			var.offset              = -1;
+			var.arrayStride         = -1;
+			var.matrixStride        = -1;
+			var.rowMajor            = false;
+			var.topLevelArraySize   = -1;
+			var.topLevelArrayStride = -1;
+
+			if(output) {
+				GLenum const indexProperty[] = { GL_LOCATION_INDEX };
+				GLint index[1];
+				detail::programResource(program, interface, i, indexProperty, index);
+				var.locationIndex = index[0];
+			}
+		}
+	}
+
+	// Uniform and storage blocks
+	for(GLenum interface : { GL_UNIFORM_BLOCK, GL_SHADER_STORAGE_BLOCK }) {
+		std::vector<ProgramBlock>& blocks = interface == GL_UNIFORM_BLOCK ? mUniformBlocks : mStorageBlocks;
+
+		GLenum const properties[] = { GL_NAME_LENGTH, GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE, GL_NUM_ACTIVE_VARIABLES };
+		GLint count = detail::programInterfaceParameter(program, interface, GL_ACTIVE_RESOURCES);
+		blocks.reserve(count);
+		for(GLint i = 0; i < count; i++) {
+			GLint v[std::size(properties)];
+			detail::programResource(program, interface, i, properties, v);
+			ProgramBlock& block = blocks.emplace_back();
+			readName(program, interface, i, v[0], block.nameOffset, block.nameHash);
+			block.binding     = v[1];
+			block.dataSize    = v[2];
+			block.firstMember = uint32_t(mBlockMembers.size());
+			block.memberCount = uint32_t(v[3]);
+
+			mBlockMembers.resize(block.firstMember + block.memberCount);
+			GLenum const membersProperty = GL_ACTIVE_VARIABLES;
+			glGetProgramResourceiv(program, interface, i, 1, &membersProperty, v[3], nullptr, reinterpret_cast<GLint*>(mBlockMembers.data() + block.firstMember));
+		}
+	}
+
+	// Subroutines, for every stage that has any
+	GLenum const stages[][3] = {
+		{ GL_VERTEX_SHADER,          GL_VERTEX_SUBROUTINE,          GL_VERTEX_SUBROUTINE_UNIFORM },
+		{ GL_TESS_CONTROL_SHADER,    GL_TESS_CONTROL_SUBROUTINE,    GL_TESS_CONTROL_SUBROUTINE_UNIFORM },
+		{ GL_TESS_EVALUATION_SHADER, GL_TESS_EVALUATION_SUBROUTINE, GL_TESS_EVALUATION_SUBROUTINE_UNIFORM },
+		{ GL_GEOMETRY_SHADER,        GL_GEOMETRY_SUBROUTINE,        GL_GEOMETRY_SUBROUTINE_UNIFORM },
+		{ GL_FRAGMENT_SHADER,        GL_FRAGMENT_SUBROUTINE,        GL_FRAGMENT_SUBROUTINE_UNIFORM },
+		{ GL_COMPUTE_SHADER,         GL_COMPUTE_SUBROUTINE,         GL_COMPUTE_SUBROUTINE_UNIFORM },
+	};
+	for(auto [stage, subroutineInterface, uniformInterface] : stages) {
+		GLint count = detail::programInterfaceParameter(program, subroutineInterface, GL_ACTIVE_RESOURCES);
+		for(GLint i = 0; i < count; i++) {
+			GLenum const properties[] = { GL_NAME_LENGTH };
+			GLint v[1];
+			detail::programResource(program, subroutineInterface, i, properties, v);
+			ProgramSubroutine& s = mSubroutines.emplace_back();
+			readName(program, subroutineInterface, i, v[0], s.nameOffset, s.nameHash);
+			s.stage = stage;
+			s.index = GLuint(i);
+		}
+
+		count = detail::programInterfaceParameter(program, uniformInterface, GL_ACTIVE_RESOURCES);
+		for(GLint i = 0; i < count; i++) {
+			GLenum const properties[] = { GL_NAME_LENGTH, GL_LOCATION, GL_ARRAY_SIZE, GL_NUM_COMPATIBLE_SUBROUTINES };
+			GLint v[std::size(properties)];
+			detail::programResource(program, uniformInterface, i, properties, v);
+			ProgramSubroutineUniform& u = mSubroutineUniforms.emplace_back();
+			readName(program, uniformInterface, i, v[0], u.nameOffset, u.nameHash);
+			u.stage           = stage;
+			u.location        = v[1];
+			u.arraySize       = v[2];
+			u.firstCompatible = uint32_t(mCompatibleSubroutines.size());
+			u.compatibleCount = uint32_t(v[3]);
+
+			mCompatibleSubroutines.resize(u.firstCompatible + u.compatibleCount);
+			GLenum const compatibleProperty = GL_COMPATIBLE_SUBROUTINES;
+			glGetProgramResourceiv(program, uniformInterface, i, 1, &compatibleProperty, v[3], nullptr, reinterpret_cast<GLint*>(mCompatibleSubroutines.data() + u.firstCompatible));
+		}
+	}
+}
+
+GLPP_DECL
+void ProgramReflection::clear() noexcept {
+	mUniforms.clear();
+	mBufferVariables.clear();
+	mInputs.clear();
+	mOutputs.clear();
+	mUniformBlocks.clear();
+	mStorageBlocks.clear();
+	mBlockMembers.clear();
+	mSubroutines.clear();
+	mSubroutineUniforms.clear();
+	mCompatibleSubroutines.clear();
+	mNames.clear();
+}
+
+GLPP_DECL
+auto ProgramReflection::members(ProgramBlock const& block) const noexcept
+	-> Range<uint32_t>
+{
+	uint32_t const* first = mBlockMembers.data() + block.firstMember;
+	return { first, first + block.memberCount };
+}
+
+GLPP_DECL
+auto ProgramReflection::compatible(ProgramSubroutineUniform const& uniform) const noexcept
+	-> Range<GLuint>
+{
+	GLuint const* first = mCompatibleSubroutines.data() + uniform.firstCompatible;
+	return { first, first + uniform.compatibleCount };
+}
+
+} // namespace gl
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Hash.hpp"
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gl {
+
+/// A uniform, buffer variable, vertex input or fragment output. Fields that don't apply to the interface are -1.
+struct ProgramVariable {
+	uint32_t nameHash;            // fnv1a of the name
+	uint32_t nameOffset;          // Into ProgramReflection::names()
+	GLenum   type;                // e.g. GL_FLOAT_VEC3, GL_SAMPLER_2D
+	GLint    arraySize;           // 1 if not an array
+	GLint    location;            // -1 inside of blocks
+	GLint    locationIndex;       // Outputs only, for dual source blending
+	GLint    block;               // Index into uniformBlocks() or storageBlocks(), -1 outside of blocks
+	GLint    offset;              // Byte offset inside the block
+	GLint    arrayStride;
+	GLint    matrixStride;
+	GLint    topLevelArraySize;   // Buffer variables only
+	GLint    topLevelArrayStride; // Buffer variables only
+	bool     rowMajor;
+};
+
+/// A uniform block or shader storage block
+struct ProgramBlock {
+	uint32_t nameHash;
+	uint32_t nameOffset;
+	GLint    binding;
+	GLint    dataSize;     // Minimum buffer size in bytes
+	uint32_t firstMember;  // See ProgramReflection::members()
+	uint32_t memberCount;
+};
+
+struct ProgramSubroutine {
+	uint32_t nameHash;
+	uint32_t nameOffset;
+	GLenum   stage;        // e.g. GL_FRAGMENT_SHADER
+	GLuint   index;        // What glUniformSubroutinesuiv takes
+};
+
+struct ProgramSubroutineUniform {
+	uint32_t nameHash;
+	uint32_t nameOffset;
+	GLenum   stage;
+	GLint    location;
+	GLint    arraySize;
+	uint32_t firstCompatible; // See ProgramReflection::compatible()
+	uint32_t compatibleCount;
+};
+
+/// Everything glGetProgramResourceiv knows about a linked program, queried once and stored in flat arrays.
+/// gl::Program builds one in link(), see Program::reflection().
+class ProgramReflection {
+public:
+	template<class T>
+	struct Range {
+		T const* first = nullptr;
+		T const* last  = nullptr;
+
+		T const* begin() const noexcept { return first; }
+		T const* end()   const noexcept { return last; }
+		size_t   size()  const noexcept { return last - first; }
+		bool     empty() const noexcept { return first == last; }
+		T const& operator[](size_t i) const noexcept { return first[i]; }
+	};
+
+	ProgramReflection() noexcept = default;
+	explicit ProgramReflection(unsigned program) { build(program); }
+
+	/// Queries all interfaces of a successfully linked program
+	void build(unsigned program);
+	void clear() noexcept;
+
+	std::vector<ProgramVariable>          const& uniforms()           const noexcept { return mUniforms; }
+	std::vector<ProgramVariable>          const& bufferVariables()    const noexcept { return mBufferVariables; }
+	std::vector<ProgramVariable>          const& inputs()             const noexcept { return mInputs; }
+	std::vector<ProgramVariable>          const& outputs()            const noexcept { return mOutputs; }
+	std::vector<ProgramBlock>             const& uniformBlocks()      const noexcept { return mUniformBlocks; }
+	std::vector<ProgramBlock>             const& storageBlocks()      const noexcept { return mStorageBlocks; }
+	std::vector<ProgramSubroutine>        const& subroutines()        const noexcept { return mSubroutines; }
+	std::vector<ProgramSubroutineUniform> const& subroutineUniforms() const noexcept { return mSubroutineUniforms; }
+
+	/// Indices of the block's members in uniforms() (uniform blocks) or bufferVariables() (storage blocks)
+	Range<uint32_t> members(ProgramBlock const& block) const noexcept;
+	/// Subroutine indices that can be assigned to the subroutine uniform
+	Range<GLuint>   compatible(ProgramSubroutineUniform const& uniform) const noexcept;
+
+	/// All names, '\0'-terminated, indexed by the nameOffset members
+	std::string const& names() const noexcept { return mNames; }
+	template<class T> std::string_view name(T const& resource) const noexcept { return mNames.c_str() + resource.nameOffset; }
+
+	/// nullptr if there is no such resource
+	ProgramVariable const* uniform(std::string_view name) const noexcept { return find(mUniforms, name); }
+	ProgramVariable const* bufferVariable(std::string_view name) const noexcept { return find(mBufferVariables, name); }
+	ProgramVariable const* input(std::string_view name) const noexcept { return find(mInputs, name); }
+	ProgramVariable const* output(std::string_view name) const noexcept { return find(mOutputs, name); }
+	ProgramBlock    const* uniformBlock(std::string_view name) const noexcept { return find(mUniformBlocks, name); }
+	ProgramBlock    const* storageBlock(std::string_view name) const noexcept { return find(mStorageBlocks, name); }
+
+private:
+	std::vector<ProgramVariable>          mUniforms;
+	std::vector<ProgramVariable>          mBufferVariables;
+	std::vector<ProgramVariable>          mInputs;
+	std::vector<ProgramVariable>          mOutputs;
+	std::vector<ProgramBlock>             mUniformBlocks;
+	std::vector<ProgramBlock>             mStorageBlocks;
+	std::vector<uint32_t>                 mBlockMembers;
+	std::vector<ProgramSubroutine>        mSubroutines;
+	std::vector<ProgramSubroutineUniform> mSubroutineUniforms;
+	std::vector<GLuint>                   mCompatibleSubroutines;
+	std::string                           mNames;
+
+	// Appends the resource's name to mNames
+	void readName(unsigned program, GLenum interface, GLuint index, GLint length, uint32_t& offset, uint32_t& hash);
+
+	template<class T>
+	T const* find(std::vector<T> const& resources, std::string_view name) const noexcept {
+		uint32_t hash = fnv1a(name);
+		for(T const& r : resources)
+			if(r.nameHash == hash && this->name(r) == name)
+				return &r;
+		return nullptr;
+	}
+};
+
+} // namespace gl
@@ -0,0 +1,371 @@
+#include "S3tc.hpp"
+
+#include "MipChain.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define GLPP_S3TC_SSE2
+#endif
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+namespace detail {
+
+// 16 texels of a 4×4 block, row by row, split into channels for the SIMD loops
+struct S3tcBlock {
+	alignas(16) float r[16], g[16], b[16];
+	uint8_t a[16];
+};
+
+struct S3tcColor { float r, g, b; };
+
+GLPP_DECL
+uint16_t packRgb565(S3tcColor c) noexcept {
+	auto quantize = [](float v, float max) { return unsigned(std::clamp(v * max / 255.f + 0.5f, 0.f, max)); };
+	return uint16_t(quantize(c.r, 31) << 11 | quantize(c.g, 63) << 5 | quantize(c.b, 31));
+}
+GLPP_DECL
+S3tcColor unpackRgb565(uint16_t c) noexcept {
+	unsigned r = c >> 11, g = c >> 5 & 63, b = c & 31;
+	return { float(r << 3 | r >> 2), float(g << 2 | g >> 4), float(b << 3 | b >> 2) };
+}
+
+// Index of the closest palette color for each texel, 2 bits per texel starting at the lowest.
+// Texels in `transparent` get index 3 (transparent black in 3 color mode), the others pick from the first `count` colors.
+GLPP_DECL
+uint32_t selectS3tcIndices(S3tcBlock const& block, S3tcColor const* palette, int count, uint32_t transparent, float& error) noexcept {
+	alignas(16) int32_t indices[16];
+	alignas(16) float   distances[16];
+	#ifdef GLPP_S3TC_SSE2
+		for(int i = 0; i < 16; i += 4) {
+			__m128 r = _mm_load_ps(block.r + i), g = _mm_load_ps(block.g + i), b = _mm_load_ps(block.b + i);
+			__m128  best      = _mm_set1_ps(1e30f);
+			__m128i bestIndex = _mm_setzero_si128();
+			for(int p = 0; p < count; p++) {
+				__m128 dr = _mm_sub_ps(r, _mm_set1_ps(palette[p].r));
+				__m128 dg = _mm_sub_ps(g, _mm_set1_ps(palette[p].g));
+				__m128 db = _mm_sub_ps(b, _mm_set1_ps(palette[p].b));
+				__m128 d  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+				__m128i closer = _mm_castps_si128(_mm_cmplt_ps(d, best));
+				best      = _mm_min_ps(d, best);
+				bestIndex = _mm_or_si128(_mm_andnot_si128(closer, bestIndex), _mm_and_si128(closer, _mm_set1_epi32(p)));
+			}
+			_mm_store_si128(reinterpret_cast<__m128i*>(indices + i), bestIndex);
+			_mm_store_ps(distances + i, best);
+		}
+	#else
+		for(int i = 0; i < 16; i++) {
+			distances[i] = 1e30f;
+			for(int p = 0; p < count; p++) {
+				float dr = block.r[i] - palette[p].r, dg = block.g[i] - palette[p].g, db = block.b[i] - palette[p].b;
+				float d  = dr * dr + dg * dg + db * db;
+				if(d < distances[i]) {
+					distances[i] = d;
+					indices[i]   = p;
+				}
+			}
+		}
+	#endif
+
+	uint32_t result = 0;
+	error = 0;
+	for(int i = 0; i < 16; i++) {
+		if(transparent >> i & 1) {
+			result |= 3u << (2 * i);
+			continue;
+		}
+		result |= uint32_t(indices[i]) << (2 * i);
+		error  += distances[i];
+	}
+	return result;
+}
+
+// A color block for two endpoints, in the order and index mapping the decoder expects
+struct S3tcColorBlock {
+	uint16_t c0, c1;
+	uint32_t indices;
+	float    error;
+};
+
+GLPP_DECL
+S3tcColorBlock evaluateS3tcEndpoints(S3tcBlock const& block, S3tcColor e0, S3tcColor e1, uint32_t transparent, bool threeColor) noexcept {
+	S3tcColorBlock result;
+	result.c0 = packRgb565(e0);
+	result.c1 = packRgb565(e1);
+	// 4 color mode needs c0 > c1, 3 color mode c0 <= c1
+	if(threeColor ? result.c0 > result.c1 : result.c0 < result.c1)
+		std::swap(result.c0, result.c1);
+
+	S3tcColor a = unpackRgb565(result.c0), b = unpackRgb565(result.c1);
+	S3tcColor palette[4] = { a, b };
+	if(threeColor || result.c0 == result.c1) {
+		// Equal endpoints decode as 3 color mode as well
+		palette[2] = { (a.r + b.r) / 2, (a.g + b.g) / 2, (a.b + b.b) / 2 };
+		result.indices = selectS3tcIndices(block, palette, 3, transparent, result.error);
+	}
+	else {
+		palette[2] = { (2 * a.r + b.r) / 3, (2 * a.g + b.g) / 3, (2 * a.b + b.b) / 3 };
+		palette[3] = { (a.r + 2 * b.r) / 3, (a.g + 2 * b.g) / 3, (a.b + 2 * b.b) / 3 };
+		result.indices = selectS3tcIndices(block, palette, 4, transparent, result.error);
+	}
+	return result;
+}
+
+// Endpoints that minimize the squared error for the given indices, false if the indices don't pin them down
+GLPP_DECL
+bool fitS3tcEndpoints(S3tcBlock const& block, S3tcColorBlock const& current, uint32_t transparent, bool threeColor, S3tcColor& e0, S3tcColor& e1) noexcept {
+	// How much of c0 each index mixes in
+	static float const kFourColor[4]  = { 1.f, 0.f, 2.f / 3.f, 1.f / 3.f };
+	static float const kThreeColor[4] = { 1.f, 0.f, 0.5f, 0.f };
+	float const* weights = threeColor || current.c0 == current.c1 ? kThreeColor : kFourColor;
+
+	float aa = 0, ab = 0, bb = 0;
+	S3tcColor ax = {}, bx = {};
+	for(int i = 0; i < 16; i++) {
+		if(transparent >> i & 1) continue;
+		float alpha = weights[current.indices >> (2 * i) & 3], beta = 1 - alpha;
+		aa += alpha * alpha;
+		ab += alpha * beta;
+		bb += beta * beta;
+		ax.r += alpha * block.r[i]; ax.g += alpha * block.g[i]; ax.b += alpha * block.b[i];
+		bx.r += beta  * block.r[i]; bx.g += beta  * block.g[i]; bx.b += beta  * block.b[i];
+	}
+	float det = aa * bb - ab * ab;
+	if(std::abs(det) < 1e-6f) return false;
+	float inv = 1.f / det;
+	e0 = { (bb * ax.r - ab * bx.r) * inv, (bb * ax.g - ab * bx.g) * inv, (bb * ax.b - ab * bx.b) * inv };
+	e1 = { (aa * bx.r - ab * ax.r) * inv, (aa * bx.g - ab * ax.g) * inv, (aa * bx.b - ab * ax.b) * inv };
+	return true;
+}
+
+GLPP_DECL
+void encodeS3tcColor(S3tcBlock const& block, bool dxt1Alpha, S3tcQuality quality, uint8_t* out) noexcept {
+	uint32_t transparent = 0;
+	if(dxt1Alpha)
+		for(int i = 0; i < 16; i++)
+			if(block.a[i] < 128) transparent |= 1u << i;
+	bool threeColor = transparent != 0;
+
+	S3tcColorBlock result;
+	if(transparent == 0xFFFF) {
+		result = { 0, 0, 0xFFFFFFFF, 0 };
+	}
+	else {
+		// Bounding box of the visible texels
+		S3tcColor lo = { 255, 255, 255 }, hi = { 0, 0, 0 }, mean = {};
+		int n = 0;
+		for(int i = 0; i < 16; i++) {
+			if(transparent >> i & 1) continue;
+			lo   = { std::min(lo.r, block.r[i]), std::min(lo.g, block.g[i]), std::min(lo.b, block.b[i]) };
+			hi   = { std::max(hi.r, block.r[i]), std::max(hi.g, block.g[i]), std::max(hi.b, block.b[i]) };
+			mean = { mean.r + block.r[i], mean.g + block.g[i], mean.b + block.b[i] };
+			n++;
+		}
+		mean = { mean.r / n, mean.g / n, mean.b / n };
+
+		if(quality == S3TC_FAST) {
+			// The box's diagonal, flipped per channel where it runs against green, pulled in a bit because the extremes are rarely hit
+			float rg = 0, bg = 0;
+			for(int i = 0; i < 16; i++) {
+				if(transparent >> i & 1) continue;
+				rg += (block.r[i] - mean.r) * (block.g[i] - mean.g);
+				bg += (block.b[i] - mean.b) * (block.g[i] - mean.g);
+			}
+			S3tcColor inset = { (hi.r - lo.r) / 16, (hi.g - lo.g) / 16, (hi.b - lo.b) / 16 };
+			S3tcColor e0 = { hi.r - inset.r, hi.g - inset.g, hi.b - inset.b };
+			S3tcColor e1 = { lo.r + inset.r, lo.g + inset.g, lo.b + inset.b };
+			if(rg < 0) std::swap(e0.r, e1.r);
+			if(bg < 0) std::swap(e0.b, e1.b);
+			result = evaluateS3tcEndpoints(block, e0, e1, transparent, threeColor);
+		}
+		else {
+			// Principal axis of the covariance by power iteration, starting at the box's diagonal
+			float c[6] = {}; // rr, rg, rb, gg, gb, bb
+			for(int i = 0; i < 16; i++) {
+				if(transparent >> i & 1) continue;
+				float r = block.r[i] - mean.r, g = block.g[i] - mean.g, b = block.b[i] - mean.b;
+				c[0] += r * r; c[1] += r * g; c[2] += r * b;
+				c[3] += g * g; c[4] += g * b; c[5] += b * b;
+			}
+			S3tcColor axis = { hi.r - lo.r, hi.g - lo.g, hi.b - lo.b };
+			for(int iteration = 0; iteration < 8; iteration++) {
+				S3tcColor next = {
+					c[0] * axis.r + c[1] * axis.g + c[2] * axis.b,
+					c[1] * axis.r + c[3] * axis.g + c[4] * axis.b,
+					c[2] * axis.r + c[4] * axis.g + c[5] * axis.b,
+				};
+				float length = std::max({ std::abs(next.r), std::abs(next.g), std::abs(next.b) });
+				if(length < 1e-6f) break;
+				axis = { next.r / length, next.g / length, next.b / length };
+			}
+
+			// Extremes of the texels projected onto it
+			float lowest = 1e30f, highest = -1e30f;
+			float axisLength2 = axis.r * axis.r + axis.g * axis.g + axis.b * axis.b;
+			for(int i = 0; i < 16; i++) {
+				if(transparent >> i & 1) continue;
+				float t = (block.r[i] - mean.r) * axis.r + (block.g[i] - mean.g) * axis.g + (block.b[i] - mean.b) * axis.b;
+				lowest  = std::min(lowest,  t);
+				highest = std::max(highest, t);
+			}
+			if(axisLength2 > 0) { lowest /= axisLength2; highest /= axisLength2; }
+			else lowest = highest = 0;
+			S3tcColor e0 = { mean.r + axis.r * highest, mean.g + axis.g * highest, mean.b + axis.b * highest };
+			S3tcColor e1 = { mean.r + axis.r * lowest,  mean.g + axis.g * lowest,  mean.b + axis.b * lowest };
+			result = evaluateS3tcEndpoints(block, e0, e1, transparent, threeColor);
+
+			// Refit the endpoints to the chosen indices while that helps
+			for(int iteration = 0; iteration < 3 && result.error > 0; iteration++) {
+				if(!fitS3tcEndpoints(block, result, transparent, threeColor, e0, e1)) break;
+				S3tcColorBlock refined = evaluateS3tcEndpoints(block, e0, e1, transparent, threeColor);
+				if(refined.error >= result.error) break;
+				result = refined;
+			}
+		}
+	}
+
+	out[0] = uint8_t(result.c0); out[1] = uint8_t(result.c0 >> 8);
+	out[2] = uint8_t(result.c1); out[3] = uint8_t(result.c1 >> 8);
+	std::memcpy(out + 4, &result.indices, 4); // Little endian like the format
+}
+
+// DXT3: 4 bits of alpha per texel
+GLPP_DECL
+void encodeS3tcExplicitAlpha(S3tcBlock const& block, uint8_t* out) noexcept {
+	for(int i = 0; i < 16; i += 2) {
+		unsigned lo = (block.a[i] * 15u + 127) / 255, hi = (block.a[i + 1] * 15u + 127) / 255;
+		out[i / 2] = uint8_t(lo | hi << 4);
+	}
+}
+
+// DXT5: two endpoints with 6 values in between, 3 bit indices
+GLPP_DECL
+void encodeS3tcInterpolatedAlpha(S3tcBlock const& block, uint8_t* out) noexcept {
+	uint8_t a0 = *std::max_element(block.a, block.a + 16);
+	uint8_t a1 = *std::min_element(block.a, block.a + 16);
+	out[0] = a0;
+	out[1] = a1;
+
+	uint64_t indices = 0;
+	if(a0 != a1) {
+		int palette[8] = { a0, a1 };
+		for(int i = 2; i < 8; i++)
+			palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+		for(int i = 0; i < 16; i++) {
+			int best = 0;
+			for(int p = 1; p < 8; p++)
+				if(std::abs(block.a[i] - palette[p]) < std::abs(block.a[i] - palette[best])) best = p;
+			indices |= uint64_t(best) << (3 * i);
+		}
+	}
+	for(int i = 0; i < 6; i++)
+		out[2 + i] = uint8_t(indices >> (8 * i));
+}
+
+} // namespace detail
+
+GLPP_DECL
+size_t compressedSize(CompressedImageFormat format, GLsizei width, GLsizei height) noexcept {
+	return size_t((width + 3) / 4) * size_t((height + 3) / 4) * blockSize(format);
+}
+
+GLPP_DECL
+void compressS3tc(
+	CompressedImageFormat format, GLsizei width, GLsizei height, void const* rgba, void* blocks,
+	S3tcQuality quality, ThreadPool* pool)
+{
+	bool dxt1 = false, dxt1Alpha = false, dxt3 = false;
+	switch(format) {
+	case COMPRESSED_RGB_S3TC_DXT1:
+	case COMPRESSED_SRGB_S3TC_DXT1:
+		dxt1 = true;
+		break;
+	case COMPRESSED_RGBA_S3TC_DXT1:
+	case COMPRESSED_SRGB_ALPHA_S3TC_DXT1:
+		dxt1 = dxt1Alpha = true;
+		break;
+	case COMPRESSED_RGBA_S3TC_DXT3:
+	case COMPRESSED_SRGB_ALPHA_S3TC_DXT3:
+		dxt3 = true;
+		break;
+	case COMPRESSED_RGBA_S3TC_DXT5:
+	case COMPRESSED_SRGB_ALPHA_S3TC_DXT5:
+		break;
+	default:
+		assert(false && "Only the S3TC formats are supported");
+		return;
+	}
+
+	size_t   blockBytes = blockSize(format);
+	GLsizei  blocksX    = (width  + 3) / 4;
+	GLsizei  blocksY    = (height + 3) / 4;
+	uint8_t const* src  = static_cast<uint8_t const*>(rgba);
+	uint8_t*       dst  = static_cast<uint8_t*>(blocks);
+
+	auto encodeRows = [&](size_t begin, size_t end) {
+		detail::S3tcBlock block;
+		for(size_t by = begin; by < end; by++) {
+			for(GLsizei bx = 0; bx < blocksX; bx++) {
+				// Partial blocks repeat the last row and column, those texels are never sampled
+				for(int i = 0; i < 16; i++) {
+					GLsizei x = std::min(GLsizei(bx * 4 + i % 4), width  - 1);
+					GLsizei y = std::min(GLsizei(by * 4 + i / 4), height - 1);
+					uint8_t const* texel = src + (size_t(y) * width + x) * 4;
+					block.r[i] = texel[0];
+					block.g[i] = texel[1];
+					block.b[i] = texel[2];
+					block.a[i] = texel[3];
+				}
+				uint8_t* out = dst + (by * blocksX + bx) * blockBytes;
+				if(dxt1) {
+					detail::encodeS3tcColor(block, dxt1Alpha, quality, out);
+					continue;
+				}
+				if(dxt3) detail::encodeS3tcExplicitAlpha(block, out);
+				else     detail::encodeS3tcInterpolatedAlpha(block, out);
+				detail::encodeS3tcColor(block, false, quality, out + 8);
+			}
+		}
+	};
+	if(pool) pool->parallelFor(size_t(blocksY), encodeRows, std::max<size_t>(1, 64 / size_t(blocksX)));
+	else     encodeRows(0, size_t(blocksY));
+}
+
+GLPP_DECL
+std::vector<uint8_t> compressS3tc(
+	CompressedImageFormat format, GLsizei width, GLsizei height, void const* rgba,
+	S3tcQuality quality, ThreadPool* pool)
+{
+	std::vector<uint8_t> result(compressedSize(format, width, height));
+	compressS3tc(format, width, height, rgba, result.data(), quality, pool);
+	return result;
+}
+
+GLPP_DECL
+void compressedTexImage(
+	TextureView2D texture, CompressedImageFormat format, MipChain const& chain,
+	S3tcQuality quality, ThreadPool* pool)
+{
+	assert(chain.format() == RGBA && chain.type() == UNSIGNED_BYTE && "Only RGBA8 chains can be compressed");
+	if(!texture.immutable())
+		texture.texStorage(chain.levels(), format, chain.width(0), chain.height(0));
+
+	std::vector<uint8_t> blocks;
+	for(GLsizei level = 0; level < chain.levels(); level++) {
+		blocks.resize(compressedSize(format, chain.width(level), chain.height(level)));
+		compressS3tc(format, chain.width(level), chain.height(level), chain.data(level), blocks.data(), quality, pool);
+		texture.compressedTexImage(level, format, chain.width(level), chain.height(level), unsigned(blocks.size()), blocks.data());
+	}
+}
+
+} // namespace gl
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Texture.hpp"
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gl {
+
+class MipChain;
+class ThreadPool;
+
+enum S3tcQuality {
+	S3TC_FAST, // Endpoints from the block's bounding box, one pass over the texels
+	S3TC_HIGH, // Endpoints along the principal axis, refined by least squares. About 3 times slower, a few dB better.
+};
+
+/// Bytes of blocks for a `width` × `height` image, partial blocks at the edges count as whole ones
+size_t compressedSize(CompressedImageFormat format, GLsizei width, GLsizei height) noexcept;
+
+/// Compresses tightly packed RGBA8 texels to DXT1, DXT3 or DXT5 blocks, `blocks` has to hold compressedSize() bytes.
+/// The sRGB formats get the same bytes, their endpoints are stored as sRGB values just like the input.
+/// COMPRESSED_RGBA_S3TC_DXT1 switches blocks with alpha below 128 to 3 color mode with transparent black, the RGB variants ignore alpha.
+/// Makes no GL calls, `pool` spreads the rows of blocks over its threads.
+void compressS3tc(
+	CompressedImageFormat format, GLsizei width, GLsizei height, void const* rgba, void* blocks,
+	S3tcQuality quality = S3TC_FAST, ThreadPool* pool = nullptr);
+std::vector<uint8_t> compressS3tc(
+	CompressedImageFormat format, GLsizei width, GLsizei height, void const* rgba,
+	S3tcQuality quality = S3TC_FAST, ThreadPool* pool = nullptr);
+
+/// Compresses every level of an RGBA, UNSIGNED_BYTE chain and uploads it with compressedTexImage(), starting at level 0 of `texture`.
+void compressedTexImage(
+	TextureView2D texture, CompressedImageFormat format, MipChain const& chain,
+	S3tcQuality quality = S3TC_FAST, ThreadPool* pool = nullptr);
+
+} // namespace gl
@@ -1,22 +1,214 @@
 #include "Sampler.hpp"
 
+#include "Hash.hpp"
+
 #include <GL/glew.h>
 
 #ifndef GLPP_DECL
 	#define GLPP_DECL
 #endif
 
+#include <utility>
+
 namespace gl {
 
 GLPP_DECL
-Sampler::Sampler() noexcept {
-	glGenSamplers(1, &mHandle);
+bool SamplerDesc::operator==(SamplerDesc const& other) const noexcept {
+	return
+		minFilter     == other.minFilter &&
+		magFilter     == other.magFilter &&
+		wrapS         == other.wrapS &&
+		wrapT         == other.wrapT &&
+		wrapR         == other.wrapR &&
+		minLod        == other.minLod &&
+		maxLod        == other.maxLod &&
+		lodBias       == other.lodBias &&
+		maxAnisotropy == other.maxAnisotropy &&
+		compare       == other.compare &&
+		compareFunc   == other.compareFunc &&
+		borderColor[0] == other.borderColor[0] &&
+		borderColor[1] == other.borderColor[1] &&
+		borderColor[2] == other.borderColor[2] &&
+		borderColor[3] == other.borderColor[3];
 }
+
+GLPP_DECL
+Sampler::Sampler(std::nullptr_t) noexcept :
+	mHandle(0)
+{}
+
+GLPP_DECL
+Sampler::Sampler() noexcept :
+	mHandle(0)
+{
+	init();
+}
+
 GLPP_DECL
 Sampler::~Sampler() noexcept {
-	glDeleteSamplers(1, &mHandle);
+	destroy();
+}
+
+GLPP_DECL
+Sampler::Sampler(SamplerDesc const& desc) noexcept :
+	Sampler()
+{
+	set(desc);
+}
+
+GLPP_DECL
+Sampler::Sampler(Sampler&& other) noexcept :
+	mHandle(std::exchange(other.mHandle, 0))
+{}
+
+GLPP_DECL
+Sampler& Sampler::operator=(Sampler&& other) noexcept {
+	destroy();
+	mHandle = std::exchange(other.mHandle, 0);
+	return *this;
+}
+
+GLPP_DECL
+void Sampler::init() noexcept {
+	destroy();
+	glCreateSamplers(1, &mHandle);
 }
 
+GLPP_DECL
+void Sampler::destroy() noexcept {
+	if(mHandle) {
+		glDeleteSamplers(1, &mHandle);
+		mHandle = 0;
+	}
+}
 
+GLPP_DECL
+void Sampler::set(SamplerDesc const& desc) noexcept {
+	minFilter(desc.minFilter);
+	magFilter(desc.magFilter);
+	wrap(desc.wrapS, desc.wrapT, desc.wrapR);
+	minLod(desc.minLod);
+	maxLod(desc.maxLod);
+	lodBias(desc.lodBias);
+	if(desc.maxAnisotropy != 1) maxAnisotropy(desc.maxAnisotropy); // GL_INVALID_ENUM without anisotropic filtering support
+	compareMode(desc.compare);
+	compareFunc(desc.compareFunc);
+	borderColor(desc.borderColor[0], desc.borderColor[1], desc.borderColor[2], desc.borderColor[3]);
+}
+
+GLPP_DECL
+void Sampler::minFilter(Filter filter) noexcept {
+	glSamplerParameteri(mHandle, GL_TEXTURE_MIN_FILTER, filter);
+}
+GLPP_DECL
+void Sampler::magFilter(Filter filter) noexcept {
+	glSamplerParameteri(mHandle, GL_TEXTURE_MAG_FILTER, filter);
+}
+GLPP_DECL
+void Sampler::wrapS(WrapMode wrap) noexcept {
+	glSamplerParameteri(mHandle, GL_TEXTURE_WRAP_S, wrap);
+}
+GLPP_DECL
+void Sampler::wrapT(WrapMode wrap) noexcept {
+	glSamplerParameteri(mHandle, GL_TEXTURE_WRAP_T, wrap);
+}
+GLPP_DECL
+void Sampler::wrapR(WrapMode wrap) noexcept {
+	glSamplerParameteri(mHandle, GL_TEXTURE_WRAP_R, wrap);
+}
+GLPP_DECL
+void Sampler::wrap(WrapMode s, WrapMode t, WrapMode r) noexcept {
+	wrapS(s);
+	wrapT(t);
+	wrapR(r);
+}
+GLPP_DECL
+void Sampler::minLod(float level) noexcept {
+	glSamplerParameterf(mHandle, GL_TEXTURE_MIN_LOD, level);
+}
+GLPP_DECL
+void Sampler::maxLod(float level) noexcept {
+	glSamplerParameterf(mHandle, GL_TEXTURE_MAX_LOD, level);
+}
+GLPP_DECL
+void Sampler::lodBias(float value) noexcept {
+	glSamplerParameterf(mHandle, GL_TEXTURE_LOD_BIAS, value);
+}
+GLPP_DECL
+void Sampler::maxAnisotropy(float f) noexcept {
+	glSamplerParameterf(mHandle, GL_TEXTURE_MAX_ANISOTROPY, f);
+}
+GLPP_DECL
+void Sampler::compareMode(bool compareRefToTexture) noexcept {
+	glSamplerParameteri(mHandle, GL_TEXTURE_COMPARE_MODE, compareRefToTexture ? GL_COMPARE_REF_TO_TEXTURE : GL_NONE);
+}
+GLPP_DECL
+void Sampler::compareFunc(CompareFunc fn) noexcept {
+	glSamplerParameteri(mHandle, GL_TEXTURE_COMPARE_FUNC, fn);
+}
+GLPP_DECL
+void Sampler::borderColor(float r, float g, float b, float a) noexcept {
+	float rgba[4] = {r, g, b, a};
+	glSamplerParameterfv(mHandle, GL_TEXTURE_BORDER_COLOR, rgba);
+}
+
+GLPP_DECL
+void Sampler::bind(unsigned textureUnit) const noexcept {
+	glBindSampler(textureUnit, mHandle);
+}
+GLPP_DECL
+void Sampler::unbind(unsigned textureUnit) noexcept {
+	glBindSampler(textureUnit, 0);
+}
+
+GLPP_DECL
+void Sampler::debugLabel(std::string_view name) noexcept {
+	glObjectLabel(GL_SAMPLER, mHandle, name.length(), name.data());
+}
+
+GLPP_DECL
+void bindSamplers(unsigned first, std::initializer_list<unsigned> samplers) noexcept {
+	bindSamplers(first, samplers.size(), samplers.begin());
+}
+GLPP_DECL
+void bindSamplers(unsigned first, size_t count, unsigned const* samplers) noexcept {
+	glBindSamplers(first, GLsizei(count), samplers);
+}
+GLPP_DECL
+void unbindSamplers(unsigned first, size_t count) noexcept {
+	glBindSamplers(first, GLsizei(count), nullptr);
+}
+
+GLPP_DECL
+Sampler const& SamplerCache::sampler(SamplerDesc const& desc) {
+	auto [iter, inserted] = mSamplers.try_emplace(desc, nullptr);
+	if(inserted) {
+		iter->second.init();
+		iter->second.set(desc);
+	}
+	return iter->second;
+}
+
+GLPP_DECL
+size_t SamplerCache::DescHash::operator()(SamplerDesc const& desc) const noexcept {
+	// Field by field, the padding after `compare` isn't guaranteed to be zero. Adding 0 turns -0 into 0, which compare equal.
+	auto add = [](uint64_t hash, auto const& value) {
+		return fnv1a64({ reinterpret_cast<char const*>(&value), sizeof(value) }, hash);
+	};
+	uint64_t hash = fnv1a64({});
+	hash = add(hash, desc.minFilter);
+	hash = add(hash, desc.magFilter);
+	hash = add(hash, desc.wrapS);
+	hash = add(hash, desc.wrapT);
+	hash = add(hash, desc.wrapR);
+	hash = add(hash, desc.minLod + 0.f);
+	hash = add(hash, desc.maxLod + 0.f);
+	hash = add(hash, desc.lodBias + 0.f);
+	hash = add(hash, desc.maxAnisotropy + 0.f);
+	hash = add(hash, desc.compare);
+	hash = add(hash, desc.compareFunc);
+	for(float c : desc.borderColor) hash = add(hash, c + 0.f);
+	return size_t(hash);
+}
 
-} // namespace gl
\ No newline at end of file
+} // namespace gl
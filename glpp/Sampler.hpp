@@ -1,18 +1,104 @@
 #pragma once
 
+#include "Texture.hpp"
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <initializer_list>
+#include <string_view>
+#include <unordered_map>
+
 namespace gl {
 
+/// Everything a Sampler holds, defaults are GL's
+struct SamplerDesc {
+	Filter      minFilter     = NEAREST_MIPMAP_LINEAR;
+	Filter      magFilter     = LINEAR;
+	WrapMode    wrapS         = WRAP;
+	WrapMode    wrapT         = WRAP;
+	WrapMode    wrapR         = WRAP;
+	float       minLod        = -1000;
+	float       maxLod        = 1000;
+	float       lodBias       = 0;
+	float       maxAnisotropy = 1;
+	bool        compare       = false; // Depth comparison (GL_COMPARE_REF_TO_TEXTURE), for sampler2DShadow and friends
+	CompareFunc compareFunc   = LESS_EQUAL;
+	float       borderColor[4] = { 0, 0, 0, 0 };
+
+	bool operator==(SamplerDesc const& other) const noexcept;
+	bool operator!=(SamplerDesc const& other) const noexcept { return !(*this == other); }
+};
+
+/// Filtering and wrapping state that overrides the texture's own, so one texture can be sampled differently by different draws.
 class Sampler {
 	unsigned mHandle;
 public:
+	Sampler(std::nullptr_t) noexcept;
 	Sampler() noexcept;
 	~Sampler() noexcept;
-	// TODO
 
-	Sampler(Sampler&& other) noexcept                 = delete;
-	Sampler& operator=(Sampler&& other) noexcept      = delete;
+	explicit Sampler(SamplerDesc const& desc) noexcept;
+
+	Sampler(Sampler&& other) noexcept;
+	Sampler& operator=(Sampler&& other) noexcept;
 	Sampler(Sampler const& other) noexcept            = delete;
 	Sampler& operator=(Sampler const& other) noexcept = delete;
+
+	void init() noexcept;
+	void destroy() noexcept;
+
+	/// Sets every parameter in `desc`. A maxAnisotropy of 1 is the default and left alone, so this works without anisotropic filtering support
+	void set(SamplerDesc const& desc) noexcept;
+
+	void minFilter(Filter) noexcept;
+	void magFilter(Filter) noexcept;
+	void filter(Filter minFilter, Filter magFilter) noexcept { this->minFilter(minFilter); this->magFilter(magFilter); }
+	void wrapS(WrapMode) noexcept;
+	void wrapT(WrapMode) noexcept;
+	void wrapR(WrapMode) noexcept;
+	void wrap(WrapMode s, WrapMode t = CLAMP_TO_EDGE, WrapMode r = CLAMP_TO_EDGE) noexcept;
+	void minLod(float level) noexcept;
+	void maxLod(float level) noexcept;
+	void lodBias(float value) noexcept;
+	void maxAnisotropy(float f) noexcept;
+	void compareMode(bool compareRefToTexture) noexcept;
+	void compareFunc(CompareFunc) noexcept;
+	void borderColor(float r, float g, float b, float a) noexcept;
+
+	void bind(unsigned textureUnit) const noexcept;
+	static void unbind(unsigned textureUnit) noexcept;
+
+	void debugLabel(std::string_view name) noexcept;
+
+	operator unsigned() const noexcept { return mHandle; }
+};
+
+/// Binds samplers to consecutive texture units starting at `first` with a single call, 0 unbinds a unit
+void bindSamplers(unsigned first, std::initializer_list<unsigned> samplers) noexcept;
+void bindSamplers(unsigned first, size_t count, unsigned const* samplers) noexcept;
+/// Unbinds `count` units starting at `first`
+void unbindSamplers(unsigned first, size_t count) noexcept;
+
+/// One shared Sampler per distinct SamplerDesc, so describing the sampling wherever it's needed doesn't create duplicate objects.
+///
+///     SamplerDesc shadow;
+///     shadow.minFilter = shadow.magFilter = LINEAR;
+///     shadow.compare   = true;
+///     cache.sampler(shadow).bind(3);
+class SamplerCache {
+public:
+	SamplerCache() noexcept = default;
+
+	/// Creates the sampler on the first call, later calls with an equal desc return the same one
+	Sampler const& sampler(SamplerDesc const& desc);
+
+	void   clear() noexcept { mSamplers.clear(); }
+	size_t size() const noexcept { return mSamplers.size(); }
+
+private:
+	struct DescHash { size_t operator()(SamplerDesc const& desc) const noexcept; };
+	std::unordered_map<SamplerDesc, Sampler, DescHash> mSamplers;
 };
 
-} // namespace gl
\ No newline at end of file
+} // namespace gl
@@ -100,31 +100,91 @@ Shader::Shader(ShaderType type, std::initializer_list<std::string_view> sources)
 	}
 }
 GLPP_DECL
+Shader::Shader(ShaderType type, std::string_view source, std::string_view defines) :
+	Shader(type)
+{
+	startCompileGLSL(source, defines);
+	if(!compileStatus()) {
+		throw std::runtime_error("Failed compiling shader:\n" + infoLog());
+	}
+}
+GLPP_DECL
 bool Shader::compileGLSL(unsigned sourceCount, char const* const* sources, int const* lengths) noexcept {
+	startCompileGLSL(sourceCount, sources, lengths);
+	return compileStatus();
+}
+GLPP_DECL
+void Shader::startCompileGLSL(unsigned sourceCount, char const* const* sources, int const* lengths) noexcept {
 	glShaderSource(mHandle, sourceCount, sources, lengths);
 	glCompileShader(mHandle);
+}
+GLPP_DECL
+void Shader::startCompileGLSL(std::string_view source, std::string_view defines) noexcept {
+	if(defines.empty()) {
+		char const* string = source.data();
+		int         length = int(source.size());
+		startCompileGLSL(1, &string, &length);
+		return;
+	}
 
-	return compileStatus();
+	// The #version line has to stay first
+	size_t   versionEnd  = 0; // Of the #version line, without the '\n'
+	unsigned versionLine = 0;
+	for(size_t lineStart = 0, lineNumber = 1; lineStart < source.size(); lineNumber++) {
+		size_t lineEnd = std::min(source.find('\n', lineStart), source.size());
+		std::string_view line = source.substr(lineStart, lineEnd - lineStart);
+		if(line.substr(std::min(line.find_first_not_of(" \t"), line.size())).substr(0, 8) == "#version") {
+			versionEnd  = lineEnd;
+			versionLine = lineNumber;
+			break;
+		}
+		lineStart = lineEnd + 1;
+	}
+	size_t restStart = versionLine ? std::min(versionEnd + 1, source.size()) : 0;
+
+	std::string lineDirective = "\n#line " + std::to_string(versionLine + 1) + "\n";
+	char const* strings[] = { source.data(),   "\n", defines.data(),      lineDirective.c_str(),     source.data() + restStart };
+	int         lengths[] = { int(versionEnd), 1,    int(defines.size()), int(lineDirective.size()), int(source.size() - restStart) };
+	startCompileGLSL(5, strings, lengths);
 }
 
 GLPP_DECL
-Shader::Shader(ShaderType type, uint8_t const* source, int len) :
+Shader::Shader(ShaderType type, uint8_t const* source, int len, char const* entryPoint, std::initializer_list<SpecializationConstant> constants) :
 	Shader(type)
 {
 	loadSpirv(source, len);
-	// TODO: specialize
-	if(!compileStatus()) {
+	if(!specialize(entryPoint, constants)) {
 		throw std::runtime_error("Failed loading spirv:\n" + infoLog());
 	}
 }
 GLPP_DECL
 void Shader::loadSpirv(uint8_t const* data, int size) noexcept {
-	glShaderBinary(1, &mHandle, GL_SPIR_V_BINARY, data, size);
+	glShaderBinary(1, &mHandle, GL_SHADER_BINARY_FORMAT_SPIR_V, data, size);
+}
+GLPP_DECL
+bool Shader::specialize(const char* entryPoint, std::initializer_list<SpecializationConstant> constants) noexcept {
+	constexpr size_t kMaxOnStack = 32;
+	GLuint ids[kMaxOnStack], values[kMaxOnStack];
+	if(constants.size() > kMaxOnStack) {
+		std::vector<GLuint> manyIds, manyValues;
+		for(SpecializationConstant const& c : constants) {
+			manyIds.push_back(c.id);
+			manyValues.push_back(c.value);
+		}
+		return specialize(entryPoint, constants.size(), manyIds.data(), manyValues.data());
+	}
+	size_t i = 0;
+	for(SpecializationConstant const& c : constants) {
+		ids[i]    = c.id;
+		values[i] = c.value;
+		i++;
+	}
+	return specialize(entryPoint, i, ids, values);
 }
 GLPP_DECL
-void Shader::specialize(const char* entry_point) noexcept {
-	glSpecializeShader(mHandle, entry_point, 0, nullptr, nullptr);
-	// TODO: check status
+bool Shader::specialize(const char* entryPoint, unsigned constantCount, GLuint const* constantIds, GLuint const* constantValues) noexcept {
+	glSpecializeShader(mHandle, entryPoint, constantCount, constantIds, constantValues);
+	return compileStatus();
 }
 
 GLPP_DECL
@@ -174,6 +234,14 @@ bool   Shader::compileStatus() noexcept {
 	return result == GL_TRUE;
 }
 
+GLPP_DECL
+bool   Shader::completionStatus() noexcept {
+	if(!GLEW_KHR_parallel_shader_compile && !GLEW_ARB_parallel_shader_compile) return true;
+	GLint result;
+	glGetShaderiv(mHandle, GL_COMPLETION_STATUS_KHR, &result);
+	return result == GL_TRUE;
+}
+
 GLPP_DECL
 void Shader::debugLabel(std::string_view name) {
 	glObjectLabel(GL_SHADER, mHandle, name.length(), name.data());
@@ -2,6 +2,9 @@
 
 #include <GL/glew.h>
 
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
 #include <string_view>
 
 
@@ -18,6 +21,23 @@ enum ShaderType : GLenum {
 
 std::string_view to_string(ShaderType type) noexcept;
 
+/// The value of a SPIR-V specialization constant, e.g. { 0, 16u }, { 1, 0.5f } or { 2, true }
+struct SpecializationConstant {
+	GLuint id;
+	GLuint value; // The bits of the value
+
+	constexpr SpecializationConstant(GLuint id, uint32_t value) noexcept : id(id), value(value) {}
+	constexpr SpecializationConstant(GLuint id, int32_t value) noexcept : id(id), value(uint32_t(value)) {}
+	constexpr SpecializationConstant(GLuint id, bool value) noexcept : id(id), value(value ? 1 : 0) {}
+	SpecializationConstant(GLuint id, float value) noexcept : id(id) { std::memcpy(&this->value, &value, sizeof(value)); }
+};
+
+/// The sources of one stage of a program, concatenated like glShaderSource does
+struct ShaderStage {
+	ShaderType                              type;
+	std::initializer_list<std::string_view> sources;
+};
+
 /// A single stage of a shader Program.
 /// Needs to be linked into a Program, after which it can be destroyed.
 class Shader {
@@ -40,12 +60,20 @@ public:
 	Shader(ShaderType type, char const* source, int len = -1);
 	Shader(ShaderType type, std::string_view source);
 	Shader(ShaderType type, std::initializer_list<std::string_view> sources);
+	/// Inserts `defines` (e.g. "#define SHADOWS 1\n") after the #version line, line numbers in the info log still match `source`
+	Shader(ShaderType type, std::string_view source, std::string_view defines);
 	[[nodiscard]] bool compileGLSL(unsigned sourceCount, char const* const* sources, int const* lengths = nullptr) noexcept;
+	/// glShaderSource and glCompileShader without waiting for the result, see completionStatus(). `defines` as above.
+	void startCompileGLSL(unsigned sourceCount, char const* const* sources, int const* lengths = nullptr) noexcept;
+	void startCompileGLSL(std::string_view source, std::string_view defines = {}) noexcept;
 
 	// Spirv
-	Shader(ShaderType type, uint8_t const* source, int len);
+	/// Loads and specializes the module, throws if that fails
+	Shader(ShaderType type, uint8_t const* source, int len, char const* entryPoint = "main", std::initializer_list<SpecializationConstant> constants = {});
 	void loadSpirv(uint8_t const* data, int size) noexcept;
-	void specialize(const char* entry_point) noexcept;
+	/// Picks the entry point of the module loaded by loadSpirv() and sets specialization constants, returns compileStatus()
+	bool specialize(const char* entryPoint, std::initializer_list<SpecializationConstant> constants = {}) noexcept;
+	bool specialize(const char* entryPoint, unsigned constantCount, GLuint const* constantIds, GLuint const* constantValues) noexcept;
 
 	// Parameters
 	ShaderType  shaderType() noexcept;
@@ -55,6 +83,8 @@ public:
 	size_t      sourceLength() noexcept;
 	std::string source() noexcept;
 	bool        compileStatus() noexcept;
+	/// Whether compileStatus() would return without waiting (GL_COMPLETION_STATUS_KHR), always true without KHR_parallel_shader_compile
+	bool        completionStatus() noexcept;
 
 	operator unsigned() noexcept { return mHandle; }
 
@@ -73,8 +103,9 @@ public:
 	explicit inline TypedShader(char    const* source, int len = -1) : Shader(kShaderType, source, len) {}
 	explicit inline TypedShader(std::string_view source) : Shader(kShaderType, source) {}
 	explicit inline TypedShader(std::initializer_list<std::string_view> sources) : Shader(kShaderType, sources) {}
+	explicit inline TypedShader(std::string_view source, std::string_view defines) : Shader(kShaderType, source, defines) {}
 	// Spirv
-	explicit inline TypedShader(uint8_t const* source, int len) noexcept : Shader(kShaderType, source, len) {}
+	explicit inline TypedShader(uint8_t const* source, int len, char const* entryPoint = "main", std::initializer_list<SpecializationConstant> constants = {}) : Shader(kShaderType, source, len, entryPoint, constants) {}
 };
 
 } // namespace detail
@@ -0,0 +1,100 @@
+#include "ShaderVariantSet.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+GLPP_DECL
+auto ShaderVariantSet::variant(ShaderType type, std::string_view source, std::initializer_list<Define> defines)
+	-> Variant
+{
+	mStats.requests++;
+
+	std::vector<Define> sorted(defines);
+	std::sort(sorted.begin(), sorted.end(), [](Define const& a, Define const& b) { return a.name < b.name; });
+	std::string block;
+	for(Define const& define : sorted) {
+		block += "#define ";
+		block += define.name;
+		if(!define.value.empty()) {
+			block += ' ';
+			block += define.value;
+		}
+		block += '\n';
+	}
+
+	uint64_t hash = fnv1a64(source, fnv1a64(block, fnv1a64({ reinterpret_cast<char const*>(&type), sizeof(type) })));
+	auto [first, last] = mVariantIndex.equal_range(hash);
+	for(auto it = first; it != last; ++it) {
+		Entry const& entry = mVariants[it->second];
+		if(entry.type == type && entry.defines == block && entry.source == source)
+			return it->second;
+	}
+
+	Variant result = Variant(mVariants.size());
+	mVariants.push_back({ type, hash, internSource(source), std::move(block) });
+	mVariantIndex.emplace(hash, result);
+	mStats.variants++;
+	return result;
+}
+
+GLPP_DECL
+Shader& ShaderVariantSet::shader(Variant variant) {
+	Entry& entry = mVariants[variant];
+	if(!entry.shader) {
+		entry.shader = Shader(entry.type, entry.source, std::string_view(entry.defines));
+		mStats.compiles++;
+	}
+	return entry.shader;
+}
+
+GLPP_DECL
+Program ShaderVariantSet::program(std::initializer_list<Variant> variants) {
+	// Start all compiles before waiting on any, so drivers with KHR_parallel_shader_compile can overlap them
+	for(Variant variant : variants) {
+		Entry& entry = mVariants[variant];
+		if(!entry.shader) {
+			entry.shader.init(entry.type);
+			entry.shader.startCompileGLSL(entry.source, entry.defines);
+			mStats.compiles++;
+		}
+	}
+	for(Variant variant : variants) {
+		Shader& shader = mVariants[variant].shader;
+		if(!shader.compileStatus()) {
+			std::string log = shader.infoLog();
+			shader.reset(); // Compiles again on the next use, maybe the source was fixed
+			throw CompilerError("Failed compiling shader:\n" + log);
+		}
+	}
+
+	Program result;
+	for(Variant variant : variants) result.attach(mVariants[variant].shader);
+	(void) result.link();
+	for(Variant variant : variants) result.detach(mVariants[variant].shader);
+	result.assertLinked();
+	return result;
+}
+
+GLPP_DECL
+void ShaderVariantSet::releaseShaders() noexcept {
+	for(Entry& entry : mVariants)
+		entry.shader.reset();
+}
+
+GLPP_DECL
+std::string_view ShaderVariantSet::internSource(std::string_view source) {
+	uint64_t hash = fnv1a64(source);
+	if(auto it = mSourceIndex.find(hash); it != mSourceIndex.end() && mSources[it->second] == source)
+		return mSources[it->second];
+	mSources.emplace_back(source);
+	mSourceIndex[hash] = mSources.size() - 1; // On a collision the newer source wins the slot, the older one stays valid
+	return mSources.back();
+}
+
+} // namespace gl
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Program.hpp"
+#include "Shader.hpp"
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace gl {
+
+/// Permutations of shaders, each distinct (stage, source, defines) is compiled once and shared by every program using it.
+/// variant() only interns, compiling happens on the first shader() or program() that needs the variant.
+///
+///     gl::ShaderVariantSet variants;
+///     auto vertex   = variants.variant(gl::VERTEX_SHADER,   vertexSource, { { "SKINNED" } });
+///     auto fragment = variants.variant(gl::FRAGMENT_SHADER, fragmentSource, { { "SHADOWS" }, { "LIGHTS", "4" } });
+///     gl::Program program = variants.program({ vertex, fragment });
+///
+/// Shaders stay alive until releaseShaders() or the set is destroyed, so linking further programs doesn't compile them again.
+class ShaderVariantSet {
+public:
+	/// Becomes "#define name value", inserted after the #version line
+	struct Define {
+		std::string_view name;
+		std::string_view value = {};
+	};
+	using Variant = uint32_t;
+
+	struct Stats {
+		size_t requests = 0; // variant() calls
+		size_t variants = 0; // Distinct ones
+		size_t compiles = 0; // Shaders compiled, more than variants if releaseShaders() was used
+	};
+
+	ShaderVariantSet() noexcept = default;
+
+	ShaderVariantSet(ShaderVariantSet&& other) noexcept = default;
+	ShaderVariantSet& operator=(ShaderVariantSet&& other) noexcept = default;
+	ShaderVariantSet(ShaderVariantSet const& other) = delete;
+	ShaderVariantSet& operator=(ShaderVariantSet const& other) = delete;
+
+	/// The defines are sorted by name, so their order doesn't make a different variant
+	Variant variant(ShaderType type, std::string_view source, std::initializer_list<Define> defines = {});
+	/// The compiled shader, compiling it if this is the first use. Throws like the Shader constructor.
+	Shader& shader(Variant variant);
+	/// Links the variants, compiling the ones that weren't yet. Throws like the Program constructor.
+	Program program(std::initializer_list<Variant> variants);
+
+	ShaderType       type(Variant variant) const noexcept { return mVariants[variant].type; }
+	std::string_view defines(Variant variant) const noexcept { return mVariants[variant].defines; }
+
+	/// Deletes the compiled shaders, programs linked from them are unaffected. Variants stay and compile again when used.
+	void releaseShaders() noexcept;
+
+	Stats const& stats() const noexcept { return mStats; }
+
+private:
+	struct Entry {
+		ShaderType       type;
+		uint64_t         hash;
+		std::string_view source;  // Into mSources
+		std::string      defines; // The define block
+		Shader           shader = nullptr;
+	};
+
+	std::deque<std::string>                   mSources; // Interned, deque so views stay valid
+	std::unordered_map<uint64_t, size_t>      mSourceIndex;
+	std::deque<Entry>                         mVariants;
+	std::unordered_multimap<uint64_t, Variant> mVariantIndex;
+	Stats                                     mStats;
+
+	std::string_view internSource(std::string_view source);
+};
+
+} // namespace gl
@@ -10,7 +10,7 @@ class [[nodiscard]] Sync {
 	GLsync mHandle = nullptr;
 public:
 	void wait      (GLuint64 timeout = GL_TIMEOUT_IGNORED) const noexcept { glWaitSync(mHandle, 0, timeout); }
-	bool waitClient(GLuint64 timeout = GL_TIMEOUT_IGNORED) const noexcept { return glClientWaitSync(mHandle, 0, timeout) != GL_TIMEOUT_EXPIRED; }
+	bool waitClient(GLuint64 timeout = GL_TIMEOUT_IGNORED) const noexcept { return glClientWaitSync(mHandle, GL_SYNC_FLUSH_COMMANDS_BIT, timeout) != GL_TIMEOUT_EXPIRED; }
 	bool signaled() const noexcept { return get(GL_SYNC_STATUS) == GL_SIGNALED; }
 	GLint get(GLenum name) const noexcept {
 		GLint value = GL_UNSIGNALED;
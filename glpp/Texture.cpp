@@ -1,11 +1,52 @@
 #include "Texture.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
 #ifndef GLPP_DECL
 	#define GLPP_DECL
 #endif
 
 namespace gl {
 
+GLPP_DECL
+unsigned componentCount(UnsizedImageFormat format) noexcept {
+	switch(format) {
+	case R:     return 1;
+	case RG:    return 2;
+	case RGB:   return 3;
+	case RGBA:  return 4;
+	case BGR:   return 3;
+	case BGRA:  return 4;
+	case DEPTH: return 1;
+	}
+	return 0;
+}
+
+GLPP_DECL
+unsigned blockSize(CompressedImageFormat format) noexcept {
+	switch(format) {
+	case COMPRESSED_RGB_S3TC_DXT1:
+	case COMPRESSED_SRGB_S3TC_DXT1:
+	case COMPRESSED_RGBA_S3TC_DXT1:
+	case COMPRESSED_SRGB_ALPHA_S3TC_DXT1:
+	case COMPRESSED_RED_RGTC1:
+	case COMPRESSED_SIGNED_RED_RGTC1:
+		return 8;
+	default:
+		return 16;
+	}
+}
+
+namespace detail {
+
+// Whether height/depth shrink with each mip level, rather than counting array layers
+constexpr bool mipmapsHeight(TextureType type) noexcept { return type != TEXTURE_1D_ARRAY; }
+constexpr bool mipmapsDepth (TextureType type) noexcept { return type == TEXTURE_3D; }
+
+} // namespace detail
+
 template<TextureType type> GLPP_DECL
 BasicTexture<type>::BasicTexture() noexcept {
 	init();
@@ -17,12 +58,17 @@ BasicTexture<type>::~BasicTexture() noexcept {
 
 template<TextureType type> GLPP_DECL
 BasicTexture<type>::BasicTexture(BasicTexture&& other) noexcept  :
-	BasicTextureView<type>(std::exchange(other.mHandle, 0))
-{}
+	BasicTextureView<type>(std::exchange(other.mHandle, 0)),
+	mInfo(std::move(other.mInfo))
+{
+	this->mShadow = std::exchange(other.mShadow, nullptr);
+}
 template<TextureType type> GLPP_DECL
 BasicTexture<type>& BasicTexture<type>::operator=(BasicTexture&& other) noexcept {
 	destroy();
 	this->mHandle = std::exchange(other.mHandle, 0);
+	this->mShadow = std::exchange(other.mShadow, nullptr);
+	mInfo         = std::move(other.mInfo);
 	return *this;
 }
 
@@ -30,9 +76,12 @@ template<TextureType type> GLPP_DECL
 BasicTexture<type>::BasicTexture(std::nullptr_t) noexcept : BasicTextureView<type>(0) {}
 template<TextureType type> GLPP_DECL
 void BasicTexture<type>::init() noexcept {
-	glGenTextures(1, &this->mHandle);
-	this->bind();
-	this->unbind();
+	destroy();
+	glCreateTextures(type, 1, &this->mHandle);
+
+	if(!mInfo) mInfo = std::make_unique<detail::TextureInfo>();
+	*mInfo = {};
+	this->mShadow = mInfo.get();
 }
 template<TextureType type> GLPP_DECL
 void BasicTexture<type>::destroy() noexcept {
@@ -40,6 +89,7 @@ void BasicTexture<type>::destroy() noexcept {
 		glDeleteTextures(1, &this->mHandle);
 		this->mHandle = 0;
 	}
+	if(mInfo) *mInfo = {};
 }
 
 template<TextureType type> GLPP_DECL
@@ -55,6 +105,32 @@ void BasicTextureView<type>::activate(unsigned index, TextureType as) noexcept {
 	glActiveTexture(GL_TEXTURE0 + index);
 	bind(as);
 }
+
+template<TextureType type> GLPP_DECL
+void BasicTextureView<type>::imageStorage(unsigned dimensions, GLint level, GLenum internalFormat, GLsizei w, GLsizei h, GLsizei d) {
+	if(level == 0 && !immutable()) {
+		// The default GL_NEAREST_MIPMAP_LINEAR needs all levels to be complete, GL_LINEAR and GL_NEAREST just the first
+		GLint   minFilter = detail::textureParameter(mHandle, GL_TEXTURE_MIN_FILTER);
+		GLsizei levels    = 1;
+		if(minFilter != GL_LINEAR && minFilter != GL_NEAREST && type != TEXTURE_RECTANGLE) {
+			GLsizei extent = std::max({ w, detail::mipmapsHeight(type) ? h : 1, detail::mipmapsDepth(type) ? d : 1 });
+			while(extent >> levels) levels++;
+		}
+		switch(dimensions) {
+		case 1: glTextureStorage1D(mHandle, levels, internalFormat, w); break;
+		case 2: glTextureStorage2D(mHandle, levels, internalFormat, w, h); break;
+		case 3: glTextureStorage3D(mHandle, levels, internalFormat, w, h, d); break;
+		}
+		if(mShadow) mShadow->storage(levels, internalFormat, w, h, d);
+		return;
+	}
+	// glTexImage* used to reallocate on a different size or format, swapping the storage behind bindings and attachments is worse than failing
+	if(!immutable())
+		throw std::invalid_argument("Specify level 0 first");
+	if(GLenum(internalFormat) != this->internalFormat() || w != width(level) || (dimensions >= 2 && h != height(level)) || (dimensions >= 3 && d != depth(level)))
+		throw std::invalid_argument("The level doesn't match the texture's immutable storage in size or format, init() the texture first to reallocate it");
+}
+
 template<TextureType type> GLPP_DECL
 void BasicTextureView<type>::texImage(
 	GLint level,
@@ -63,8 +139,8 @@ void BasicTextureView<type>::texImage(
 	gl::UnsizedImageFormat fmt, gl::BasicType dataType,
 	const void* data)
 {
-	glBindTexture(type, *this);
-	glTexImage1D(type, level, internalFormat, w, 0, fmt, dataType, data);
+	imageStorage(1, level, internalFormat, w, 1, 1);
+	if(data) glTextureSubImage1D(mHandle, level, 0, w, fmt, dataType, data);
 }
 template<TextureType type> GLPP_DECL
 void BasicTextureView<type>::texImage(
@@ -74,20 +150,21 @@ void BasicTextureView<type>::texImage(
 	gl::UnsizedImageFormat fmt, gl::BasicType dataType,
 	const void* data)
 {
-	glBindTexture(type, *this);
-	glTexImage2D(type, level, internalFormat, w, h, 0, fmt, dataType, data);
+	imageStorage(2, level, internalFormat, w, h, 1);
+	if(data) glTextureSubImage2D(mHandle, level, 0, 0, w, h, fmt, dataType, data);
 }
 template<TextureType type> GLPP_DECL
 void BasicTextureView<type>::texImage(
-	CubemapFace cubemapFaceIndex,
+	CubemapFace cubemapFace,
 	GLint level,
 	SizedImageFormat internalFormat,
 	GLsizei w, GLsizei h,
 	UnsizedImageFormat fmt, gl::BasicType dataType,
 	const void* data)
 {
-	glBindTexture(type, *this);
-	glTexImage2D(cubemapFaceIndex, level, internalFormat, w, h, 0, fmt, dataType, data);
+	// The storage covers all 6 faces, DSA addresses them as layers
+	imageStorage(2, level, internalFormat, w, h, 1);
+	if(data) glTextureSubImage3D(mHandle, level, 0, 0, cubemapFace - CUBEMAP_POSITIVE_X, w, h, 1, fmt, dataType, data);
 }
 template<TextureType type> GLPP_DECL
 void BasicTextureView<type>::texImage(
@@ -97,8 +174,8 @@ void BasicTextureView<type>::texImage(
 	gl::UnsizedImageFormat fmt, gl::BasicType dataType,
 	const void* data)
 {
-	glBindTexture(type, *this);
-	glTexImage3D(type, level, internalFormat, w, h, d, 0, fmt, dataType, data);
+	imageStorage(3, level, internalFormat, w, h, d);
+	if(data) glTextureSubImage3D(mHandle, level, 0, 0, 0, w, h, d, fmt, dataType, data);
 }
 
 template<TextureType type> GLPP_DECL
@@ -109,8 +186,8 @@ void BasicTextureView<type>::compressedTexImage(
 	unsigned dataSize,
 	const void* data)
 {
-	glBindTexture(type, *this);
-	glCompressedTexImage1D(type, level, format, w, 0, dataSize, data);
+	imageStorage(1, level, format, w, 1, 1);
+	if(data) glCompressedTextureSubImage1D(mHandle, level, 0, w, format, dataSize, data);
 }
 template<TextureType type> GLPP_DECL
 void BasicTextureView<type>::compressedTexImage(
@@ -120,8 +197,8 @@ void BasicTextureView<type>::compressedTexImage(
 	unsigned dataSize,
 	const void* data)
 {
-	glBindTexture(type, *this);
-	glCompressedTexImage2D(type, level, format, w, h, 0, dataSize, data);
+	imageStorage(2, level, format, w, h, 1);
+	if(data) glCompressedTextureSubImage2D(mHandle, level, 0, 0, w, h, format, dataSize, data);
 }
 template<TextureType type> GLPP_DECL
 void BasicTextureView<type>::compressedTexImage(
@@ -131,8 +208,8 @@ void BasicTextureView<type>::compressedTexImage(
 	unsigned dataSize,
 	const void* data)
 {
-	glBindTexture(type, *this);
-	glCompressedTexImage3D(type, level, format, w, h, d, 0, dataSize, data);
+	imageStorage(3, level, format, w, h, d);
+	if(data) glCompressedTextureSubImage3D(mHandle, level, 0, 0, 0, w, h, d, format, dataSize, data);
 }
 
 template<TextureType type>
@@ -174,17 +251,60 @@ void BasicTextureView<type>::texSubimage(
 	glTextureSubImage3D(mHandle, level, xoff, yoff, zoff, width, height, depth, format, pxtype, pixels);
 }
 
+template<TextureType type> GLPP_DECL
+void BasicTextureView<type>::compressedTexSubimage(
+	GLsizei level,
+	GLsizei xoff, GLsizei width,
+	CompressedImageFormat format, unsigned dataSize, void const* data)
+{
+	glCompressedTextureSubImage1D(mHandle, level, xoff, width, format, dataSize, data);
+}
+template<TextureType type> GLPP_DECL
+void BasicTextureView<type>::compressedTexSubimage(
+	GLsizei level,
+	GLsizei xoff, GLsizei yoff, GLsizei width, GLsizei height,
+	CompressedImageFormat format, unsigned dataSize, void const* data)
+{
+	glCompressedTextureSubImage2D(mHandle, level, xoff, yoff, width, height, format, dataSize, data);
+}
+template<TextureType type> GLPP_DECL
+void BasicTextureView<type>::compressedTexSubimage(
+	GLsizei level,
+	GLsizei xoff, GLsizei yoff, GLsizei zoff, GLsizei width, GLsizei height, GLsizei depth,
+	CompressedImageFormat format, unsigned dataSize, void const* data)
+{
+	glCompressedTextureSubImage3D(mHandle, level, xoff, yoff, zoff, width, height, depth, format, dataSize, data);
+}
+
 template<TextureType type> GLPP_DECL
 void BasicTextureView<type>::texStorage(GLsizei levels, SizedImageFormat internalFormat, GLsizei width) noexcept {
 	glTextureStorage1D(mHandle, levels, internalFormat, width);
+	if(mShadow) mShadow->storage(levels, internalFormat, width, 1, 1);
 }
 template<TextureType type> GLPP_DECL
 void BasicTextureView<type>::texStorage(GLsizei levels, SizedImageFormat internalFormat, GLsizei width, GLsizei height) noexcept {
 	glTextureStorage2D(mHandle, levels, internalFormat, width, height);
+	if(mShadow) mShadow->storage(levels, internalFormat, width, height, 1);
 }
 template<TextureType type> GLPP_DECL
 void BasicTextureView<type>::texStorage(GLsizei levels, SizedImageFormat internalFormat, GLsizei width, GLsizei height, GLsizei depth) noexcept {
 	glTextureStorage3D(mHandle, levels, internalFormat, width, height, depth);
+	if(mShadow) mShadow->storage(levels, internalFormat, width, height, depth);
+}
+template<TextureType type> GLPP_DECL
+void BasicTextureView<type>::texStorage(GLsizei levels, CompressedImageFormat internalFormat, GLsizei width) noexcept {
+	glTextureStorage1D(mHandle, levels, internalFormat, width);
+	if(mShadow) mShadow->storage(levels, internalFormat, width, 1, 1);
+}
+template<TextureType type> GLPP_DECL
+void BasicTextureView<type>::texStorage(GLsizei levels, CompressedImageFormat internalFormat, GLsizei width, GLsizei height) noexcept {
+	glTextureStorage2D(mHandle, levels, internalFormat, width, height);
+	if(mShadow) mShadow->storage(levels, internalFormat, width, height, 1);
+}
+template<TextureType type> GLPP_DECL
+void BasicTextureView<type>::texStorage(GLsizei levels, CompressedImageFormat internalFormat, GLsizei width, GLsizei height, GLsizei depth) noexcept {
+	glTextureStorage3D(mHandle, levels, internalFormat, width, height, depth);
+	if(mShadow) mShadow->storage(levels, internalFormat, width, height, depth);
 }
 
 template<TextureType type> GLPP_DECL
@@ -294,6 +414,97 @@ void BasicTextureView<type>::maxAnisotropy(float f) noexcept {
 	glTextureParameterf(mHandle, GL_TEXTURE_MAX_ANISOTROPY, f);
 }
 
+namespace detail {
+
+GLPP_DECL
+GLint textureLevelParameter(unsigned texture, GLint level, GLenum parameter) noexcept {
+	GLint result = 0;
+	glGetTextureLevelParameteriv(texture, level, parameter, &result);
+	return result;
+}
+
+GLPP_DECL
+GLint textureParameter(unsigned texture, GLenum parameter) noexcept {
+	GLint result = 0;
+	glGetTextureParameteriv(texture, parameter, &result);
+	return result;
+}
+
+GLPP_DECL
+void textureSubImage(unsigned dimensions, unsigned texture, GLsizei level, GLsizei const* offset, GLsizei const* size, GLenum format, GLenum type, void const* pixels) noexcept {
+	switch(dimensions) {
+	case 1: glTextureSubImage1D(texture, level, offset[0], size[0], format, type, pixels); break;
+	case 2: glTextureSubImage2D(texture, level, offset[0], offset[1], size[0], size[1], format, type, pixels); break;
+	case 3: glTextureSubImage3D(texture, level, offset[0], offset[1], offset[2], size[0], size[1], size[2], format, type, pixels); break;
+	}
+}
+
+GLPP_DECL
+GLsizei mipExtent(TextureInfo const& info, GLsizei extent, bool mipmapped, GLint level) noexcept {
+	if(level >= info.levels) return 0;
+	return mipmapped ? std::max(extent >> level, 1) : extent;
+}
+
+} // namespace detail
+
+#define GLPP_CHECK_TEXTURE_SHADOW(VALUE, QUERY) \
+	assert((VALUE) == (QUERY) && "Shadowed texture state is out of date, was the texture modified through its raw handle?")
+
+template<TextureType type> GLPP_DECL
+GLsizei BasicTextureView<type>::width(GLint level) noexcept {
+	if(!mShadow) return detail::textureLevelParameter(mHandle, level, GL_TEXTURE_WIDTH);
+	GLsizei result = detail::mipExtent(*mShadow, mShadow->width, true, level);
+	GLPP_CHECK_TEXTURE_SHADOW(result, detail::textureLevelParameter(mHandle, level, GL_TEXTURE_WIDTH));
+	return result;
+}
+template<TextureType type> GLPP_DECL
+GLsizei BasicTextureView<type>::height(GLint level) noexcept {
+	if(!mShadow) return detail::textureLevelParameter(mHandle, level, GL_TEXTURE_HEIGHT);
+	GLsizei result = detail::mipExtent(*mShadow, mShadow->height, detail::mipmapsHeight(type), level);
+	GLPP_CHECK_TEXTURE_SHADOW(result, detail::textureLevelParameter(mHandle, level, GL_TEXTURE_HEIGHT));
+	return result;
+}
+template<TextureType type> GLPP_DECL
+GLsizei BasicTextureView<type>::depth(GLint level) noexcept {
+	if(!mShadow) return detail::textureLevelParameter(mHandle, level, GL_TEXTURE_DEPTH);
+	GLsizei result = detail::mipExtent(*mShadow, mShadow->depth, detail::mipmapsDepth(type), level);
+	GLPP_CHECK_TEXTURE_SHADOW(result, detail::textureLevelParameter(mHandle, level, GL_TEXTURE_DEPTH));
+	return result;
+}
+template<TextureType type> GLPP_DECL
+GLsizei BasicTextureView<type>::levels() noexcept {
+	if(!mShadow) {
+		if(detail::textureParameter(mHandle, GL_TEXTURE_IMMUTABLE_FORMAT))
+			return detail::textureParameter(mHandle, GL_TEXTURE_IMMUTABLE_LEVELS);
+
+		GLint maxSize = 0;
+		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+		GLsizei result = 0;
+		while((maxSize >> result) && detail::textureLevelParameter(mHandle, result, GL_TEXTURE_WIDTH))
+			result++;
+		return result;
+	}
+	// Mutable textures have no query for this, there's nothing to compare against
+	if(mShadow->immutable)
+		GLPP_CHECK_TEXTURE_SHADOW(mShadow->levels, detail::textureParameter(mHandle, GL_TEXTURE_IMMUTABLE_LEVELS));
+	return mShadow->levels;
+}
+template<TextureType type> GLPP_DECL
+GLenum BasicTextureView<type>::internalFormat() noexcept {
+	if(!mShadow) return detail::textureLevelParameter(mHandle, 0, GL_TEXTURE_INTERNAL_FORMAT);
+	if(mShadow->levels > 0)
+		GLPP_CHECK_TEXTURE_SHADOW(mShadow->internalFormat, GLenum(detail::textureLevelParameter(mHandle, 0, GL_TEXTURE_INTERNAL_FORMAT)));
+	return mShadow->internalFormat;
+}
+template<TextureType type> GLPP_DECL
+bool BasicTextureView<type>::immutable() noexcept {
+	if(!mShadow) return detail::textureParameter(mHandle, GL_TEXTURE_IMMUTABLE_FORMAT) == GL_TRUE;
+	GLPP_CHECK_TEXTURE_SHADOW(mShadow->immutable, detail::textureParameter(mHandle, GL_TEXTURE_IMMUTABLE_FORMAT) == GL_TRUE);
+	return mShadow->immutable;
+}
+
+#undef GLPP_CHECK_TEXTURE_SHADOW
+
 template<TextureType type> GLPP_DECL
 void BasicTextureView<type>::debugLabel(std::string_view name) noexcept {
 	glObjectLabel(GL_TEXTURE, mHandle, name.size(), name.data());
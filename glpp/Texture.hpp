@@ -5,6 +5,7 @@
 #include <GL/glew.h>
 
 #include <cstddef>
+#include <memory>
 #include <string_view>
 
 #include <array>
@@ -73,17 +74,30 @@ enum UnsizedImageFormat {
 	DEPTH = GL_DEPTH_COMPONENT
 };
 
+unsigned componentCount(UnsizedImageFormat format) noexcept;
+
 enum CompressedImageFormat {
-	COMPRESSED_RGB_S3TC_DXT1        = GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
-	COMPRESSED_SRGB_S3TC_DXT1       = GL_COMPRESSED_SRGB_S3TC_DXT1_EXT,
-	COMPRESSED_RGBA_S3TC_DXT1       = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
-	COMPRESSED_SRGB_ALPHA_S3TC_DXT1 = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT,
-	COMPRESSED_RGBA_S3TC_DXT3       = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,
-	COMPRESSED_SRGB_ALPHA_S3TC_DXT3 = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT,
-	COMPRESSED_RGBA_S3TC_DXT5       = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
-	COMPRESSED_SRGB_ALPHA_S3TC_DXT5 = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+	COMPRESSED_RGB_S3TC_DXT1           = GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+	COMPRESSED_SRGB_S3TC_DXT1          = GL_COMPRESSED_SRGB_S3TC_DXT1_EXT,
+	COMPRESSED_RGBA_S3TC_DXT1          = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+	COMPRESSED_SRGB_ALPHA_S3TC_DXT1    = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT,
+	COMPRESSED_RGBA_S3TC_DXT3          = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,
+	COMPRESSED_SRGB_ALPHA_S3TC_DXT3    = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT,
+	COMPRESSED_RGBA_S3TC_DXT5          = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+	COMPRESSED_SRGB_ALPHA_S3TC_DXT5    = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT,
+	COMPRESSED_RED_RGTC1               = GL_COMPRESSED_RED_RGTC1,
+	COMPRESSED_SIGNED_RED_RGTC1        = GL_COMPRESSED_SIGNED_RED_RGTC1,
+	COMPRESSED_RG_RGTC2                = GL_COMPRESSED_RG_RGTC2,
+	COMPRESSED_SIGNED_RG_RGTC2         = GL_COMPRESSED_SIGNED_RG_RGTC2,
+	COMPRESSED_RGBA_BPTC_UNORM         = GL_COMPRESSED_RGBA_BPTC_UNORM,
+	COMPRESSED_SRGB_ALPHA_BPTC_UNORM   = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,
+	COMPRESSED_RGB_BPTC_SIGNED_FLOAT   = GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT,
+	COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT = GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT
 };
 
+/// Bytes per 4×4 block: 8 for DXT1 and RGTC1, 16 for the others
+unsigned blockSize(CompressedImageFormat format) noexcept;
+
 enum WrapMode {
 	CLAMP = GL_CLAMP,
 	CLAMP_TO_EDGE   = GL_CLAMP_TO_EDGE,
@@ -103,14 +117,14 @@ enum Filter {
 };
 
 enum CompareFunc {
-	LESS_EQUAL,
-	GREATER_EQUAL,
-	LESS,
-	GREATER,
-	EQUAL,
-	NOTEQUAL,
-	ALWAYS,
-	NEVER
+	LESS_EQUAL    = GL_LEQUAL,
+	GREATER_EQUAL = GL_GEQUAL,
+	LESS          = GL_LESS,
+	GREATER       = GL_GREATER,
+	EQUAL         = GL_EQUAL,
+	NOTEQUAL      = GL_NOTEQUAL,
+	ALWAYS        = GL_ALWAYS,
+	NEVER         = GL_NEVER
 };
 
 enum ColorComponent {
@@ -146,10 +160,46 @@ constexpr std::array<CubemapFaceIndex, 6> cubemapFaceIndices() noexcept {
 	return { CUBEMAP_POSITIVE_X_IDX, CUBEMAP_NEGATIVE_X_IDX, CUBEMAP_POSITIVE_Y_IDX, CUBEMAP_NEGATIVE_Y_IDX, CUBEMAP_POSITIVE_Z_IDX, CUBEMAP_NEGATIVE_Z_IDX };
 }
 
+namespace detail {
+
+// Client side copy of a texture's format and extent, kept up to date by gl::BasicTexture so the getters don't have to ask the driver
+struct TextureInfo {
+	GLenum  internalFormat = 0;
+	GLsizei width  = 0; // Of level 0
+	GLsizei height = 0;
+	GLsizei depth  = 0;
+	GLsizei levels = 0;
+	bool    immutable = false;
+
+	void storage(GLsizei n, GLenum format, GLsizei w, GLsizei h, GLsizei d) noexcept {
+		internalFormat = format;
+		width  = w;
+		height = h;
+		depth  = d;
+		levels    = n;
+		immutable = true;
+	}
+};
+
+GLint textureLevelParameter(unsigned texture, GLint level, GLenum parameter) noexcept;
+GLint textureParameter(unsigned texture, GLenum parameter) noexcept;
+// glTextureSubImage1D/2D/3D depending on `dimensions`
+void textureSubImage(unsigned dimensions, unsigned texture, GLsizei level, GLsizei const* offset, GLsizei const* size, GLenum format, GLenum type, void const* pixels) noexcept;
+
+} // namespace detail
+
+/// Binding state: only bind(), unbind() and activate() touch texture bindings or the active texture unit.
+/// Everything else goes through DSA (glCreateTextures, glTextureStorage*, glTextureSubImage*, glCompressedTextureSubImage*, glTextureParameter*),
+/// so caches of what is bound where stay valid across texture creation and uploads.
+/// Uploads do read the current GL_PIXEL_UNPACK_BUFFER binding and unpack state (GL_UNPACK_ALIGNMENT etc.).
 template<TextureType tType>
 class BasicTextureView {
 protected:
-	unsigned mHandle;
+	unsigned             mHandle;
+	detail::TextureInfo* mShadow = nullptr; // Owned by the gl::BasicTexture this is a view of, if any
+
+	// texImage() and compressedTexImage() allocate immutable storage on level 0, and check that later calls match it
+	void imageStorage(unsigned dimensions, GLint level, GLenum internalFormat, GLsizei w, GLsizei h, GLsizei d);
 public:
 	BasicTextureView(unsigned handle = 0) noexcept : mHandle(handle) {}
 
@@ -162,6 +212,12 @@ public:
 	static void unbind(TextureType from = type) noexcept;
 	void activate(unsigned index, TextureType as = type) noexcept;
 
+	/// Level 0 allocates immutable storage: all mip levels if the min filter uses mipmaps (the default does), only level 0 otherwise.
+	/// Later levels (and cubemap faces) upload into that storage and have to match its size and format.
+	/// Use texStorage() to pick the number of levels yourself.
+	/// Unlike glTexImage*, specifying level 0 again with another size or format doesn't reallocate: the storage is immutable and the handle
+	/// has to stay the same for bindings and framebuffer attachments, so any upload that doesn't match the storage throws std::invalid_argument.
+	/// Call gl::BasicTexture::init() first to get new storage under a new handle.
 	void texImage(
 		GLint level,
 		SizedImageFormat internalFormat,
@@ -225,9 +281,27 @@ public:
 		GLsizei xoff, GLsizei yoff, GLsizei zoff, GLsizei width, GLsizei height, GLsizei depth,
 		UnsizedImageFormat format, BasicType pxtype, void const* pixels);
 
+	/// Offsets and sizes are in texels and have to be multiples of 4, except where the region touches the level's right or bottom edge.
+	/// `format` has to be the storage's, `dataSize` is the number of bytes of blocks in `data`.
+	void compressedTexSubimage(
+		GLsizei level,
+		GLsizei xoff, GLsizei width,
+		CompressedImageFormat format, unsigned dataSize, void const* data);
+	void compressedTexSubimage(
+		GLsizei level,
+		GLsizei xoff, GLsizei yoff, GLsizei width, GLsizei height,
+		CompressedImageFormat format, unsigned dataSize, void const* data);
+	void compressedTexSubimage(
+		GLsizei level,
+		GLsizei xoff, GLsizei yoff, GLsizei zoff, GLsizei width, GLsizei height, GLsizei depth,
+		CompressedImageFormat format, unsigned dataSize, void const* data);
+
 	void texStorage(GLsizei levels, SizedImageFormat internalFormat, GLsizei width) noexcept;
 	void texStorage(GLsizei levels, SizedImageFormat internalFormat, GLsizei width, GLsizei height) noexcept;
 	void texStorage(GLsizei levels, SizedImageFormat internalFormat, GLsizei width, GLsizei height, GLsizei depth) noexcept;
+	void texStorage(GLsizei levels, CompressedImageFormat internalFormat, GLsizei width) noexcept;
+	void texStorage(GLsizei levels, CompressedImageFormat internalFormat, GLsizei width, GLsizei height) noexcept;
+	void texStorage(GLsizei levels, CompressedImageFormat internalFormat, GLsizei width, GLsizei height, GLsizei depth) noexcept;
 
 	void bindTextureUnit(unsigned textureUnit) const noexcept; // sampler in glsl
 	static void unbindTextureUnit(unsigned textureUnit) noexcept; // sampler in glsl
@@ -257,6 +331,15 @@ public:
 	float maxAnisotropy() noexcept;
 	void  maxAnisotropy(float f) noexcept;
 
+	// Getters: Plain member reads on a gl::BasicTexture (or a view copied from one), driver queries otherwise.
+	// Debug builds compare the two, so modifying a gl::BasicTexture through its raw handle trips an assert.
+	GLsizei width (GLint level = 0) noexcept;
+	GLsizei height(GLint level = 0) noexcept; // Number of layers for 1D arrays
+	GLsizei depth (GLint level = 0) noexcept; // Number of layers (times 6 for cubemaps) for arrays
+	GLsizei levels() noexcept;
+	GLenum  internalFormat() noexcept;
+	bool    immutable() noexcept;
+
 	void debugLabel(std::string_view name) noexcept;
 
 	operator unsigned() noexcept { return mHandle; }
@@ -275,8 +358,13 @@ public:
 	BasicTexture(BasicTexture const& other) noexcept            = delete;
 	BasicTexture& operator=(BasicTexture const& other) noexcept = delete;
 
+	/// Replaces the texture with a new, empty one, e.g. to resize it. The handle changes: parameters are reset,
+	/// framebuffer attachments and texture bindings have to be redone and views taken before refer to the deleted texture.
 	void init() noexcept;
 	void destroy() noexcept;
+
+private:
+	std::unique_ptr<detail::TextureInfo> mInfo; // On the heap so views stay valid when the texture is moved
 };
 
 inline namespace texture_types {
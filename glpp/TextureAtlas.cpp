@@ -0,0 +1,235 @@
+#include "TextureAtlas.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+namespace detail {
+
+GLPP_DECL
+void Skyline::reset(GLsizei width, GLsizei height) noexcept {
+	mWidth  = width;
+	mHeight = height;
+	mNodes.assign(1, { 0, 0, width });
+}
+
+GLPP_DECL
+bool Skyline::allocate(GLsizei w, GLsizei h, GLsizei& x, GLsizei& y) noexcept {
+	// Lowest top edge wins, the narrower node breaks ties
+	size_t  best      = mNodes.size();
+	GLsizei bestY     = std::numeric_limits<GLsizei>::max();
+	GLsizei bestWidth = std::numeric_limits<GLsizei>::max();
+	for(size_t i = 0; i < mNodes.size(); i++) {
+		if(mNodes[i].x + w > mWidth) break;
+
+		// The image rests on the highest node it spans
+		GLsizei top = 0;
+		GLsizei spanned = 0;
+		for(size_t j = i; spanned < w; j++) {
+			top      = std::max(top, mNodes[j].y);
+			spanned += mNodes[j].width;
+		}
+		if(top + h > mHeight) continue;
+		if(top < bestY || (top == bestY && mNodes[i].width < bestWidth)) {
+			best      = i;
+			bestY     = top;
+			bestWidth = mNodes[i].width;
+		}
+	}
+	if(best == mNodes.size()) return false;
+
+	x = mNodes[best].x;
+	y = bestY;
+
+	// Replace the spanned part of the skyline with the new top edge
+	mNodes.insert(mNodes.begin() + best, { x, y + h, w });
+	size_t next = best + 1;
+	while(next < mNodes.size() && mNodes[next].x < x + w) {
+		GLsizei overlap = x + w - mNodes[next].x;
+		if(overlap < mNodes[next].width) {
+			mNodes[next].x     += overlap;
+			mNodes[next].width -= overlap;
+			break;
+		}
+		mNodes.erase(mNodes.begin() + next);
+	}
+	// Merge neighbours at the same height
+	for(size_t i = 0; i + 1 < mNodes.size();) {
+		if(mNodes[i].y == mNodes[i + 1].y) {
+			mNodes[i].width += mNodes[i + 1].width;
+			mNodes.erase(mNodes.begin() + i + 1);
+		}
+		else i++;
+	}
+	return true;
+}
+
+} // namespace detail
+
+GLPP_DECL
+TextureAtlas::TextureAtlas(std::nullptr_t) noexcept :
+	mTexture(nullptr)
+{}
+
+GLPP_DECL
+TextureAtlas::TextureAtlas(SizedImageFormat format, GLsizei size, GLsizei layers, GLsizei levels, GLsizei padding) noexcept :
+	TextureAtlas(nullptr)
+{
+	init(format, size, layers, levels, padding);
+}
+
+GLPP_DECL
+void TextureAtlas::init(SizedImageFormat format, GLsizei size, GLsizei layers, GLsizei levels, GLsizei padding) noexcept {
+	destroy();
+
+	mTexture.init();
+	mTexture.texStorage(levels, format, size, size, layers);
+	mTexture.filter(levels > 1 ? TRILINEAR : LINEAR, LINEAR);
+	mTexture.wrap(CLAMP_TO_EDGE, CLAMP_TO_EDGE);
+
+	mSize      = size;
+	mAlignment = 1 << (levels - 1);
+	mPadding   = padding >= 0 ? padding : mAlignment;
+	mLayers.resize(layers);
+	for(Layer& layer : mLayers)
+		layer.packer.reset(size, size);
+}
+
+GLPP_DECL
+void TextureAtlas::destroy() noexcept {
+	mTexture.destroy();
+	mLayers.clear();
+	mEntries.clear();
+	mScratch.clear();
+	mSize  = 0;
+	mFrame = 1;
+	mDirty = false;
+	mStats = {};
+}
+
+GLPP_DECL
+auto TextureAtlas::find(uint64_t key) noexcept
+	-> Region const*
+{
+	auto iter = mEntries.find(key);
+	if(iter == mEntries.end()) {
+		mStats.misses++;
+		return nullptr;
+	}
+	mStats.hits++;
+	mLayers[iter->second.layer].lastUsed = mFrame;
+	return &iter->second;
+}
+
+GLPP_DECL
+auto TextureAtlas::insert(uint64_t key, GLsizei width, GLsizei height, UnsizedImageFormat format, BasicType pxtype, void const* pixels)
+	-> Region const*
+{
+	erase(key);
+
+	GLsizei paddedWidth  = width  + 2 * mPadding;
+	GLsizei paddedHeight = height + 2 * mPadding;
+	GLsizei slotWidth    = (paddedWidth  + mAlignment - 1) / mAlignment * mAlignment;
+	GLsizei slotHeight   = (paddedHeight + mAlignment - 1) / mAlignment * mAlignment;
+	if(slotWidth > mSize || slotHeight > mSize) return nullptr;
+
+	// First fit over the layers, then the least recently used one gets cleared
+	GLsizei x = 0, y = 0;
+	Layer*  target = nullptr;
+	for(Layer& layer : mLayers) {
+		if(layer.packer.allocate(slotWidth, slotHeight, x, y)) {
+			target = &layer;
+			break;
+		}
+	}
+	if(!target) {
+		Layer& oldest = *std::min_element(mLayers.begin(), mLayers.end(), [](Layer const& a, Layer const& b) { return a.lastUsed < b.lastUsed; });
+		if(oldest.lastUsed == mFrame) return nullptr; // Everything is in use, evicting would break this frame's draws
+		evict(oldest);
+		(void) oldest.packer.allocate(slotWidth, slotHeight, x, y);
+		target = &oldest;
+	}
+	unsigned layerIndex = unsigned(target - mLayers.data());
+	target->lastUsed = mFrame;
+	target->keys.push_back(key);
+
+	// Copy the image into the middle of the padded block and repeat its edge texels outwards
+	size_t pixelBytes = componentCount(format) * sizeOf(pxtype);
+	mScratch.resize(size_t(paddedWidth) * paddedHeight * pixelBytes);
+	for(GLsizei row = 0; row < paddedHeight; row++) {
+		GLsizei srcRow = std::clamp(row - mPadding, 0, height - 1);
+		uint8_t const* src = static_cast<uint8_t const*>(pixels) + size_t(srcRow) * width * pixelBytes;
+		uint8_t*       dst = mScratch.data() + size_t(row) * paddedWidth * pixelBytes;
+		for(GLsizei column = 0; column < mPadding; column++) {
+			std::memcpy(dst + size_t(column) * pixelBytes, src, pixelBytes);
+			std::memcpy(dst + size_t(mPadding + width + column) * pixelBytes, src + size_t(width - 1) * pixelBytes, pixelBytes);
+		}
+		std::memcpy(dst + size_t(mPadding) * pixelBytes, src, size_t(width) * pixelBytes);
+	}
+
+	GLint unpackAlignment = 0;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	mTexture.texSubimage(0, x, y, GLsizei(layerIndex), paddedWidth, paddedHeight, 1, format, pxtype, mScratch.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+	mDirty = true;
+
+	float scale = 1.f / float(mSize);
+	Region& region = mEntries[key];
+	region.layer  = layerIndex;
+	region.x      = x + mPadding;
+	region.y      = y + mPadding;
+	region.width  = width;
+	region.height = height;
+	region.uv[0]  = float(region.x) * scale;
+	region.uv[1]  = float(region.y) * scale;
+	region.uv[2]  = float(region.x + width)  * scale;
+	region.uv[3]  = float(region.y + height) * scale;
+
+	mStats.inserts++;
+	return &region;
+}
+
+GLPP_DECL
+void TextureAtlas::erase(uint64_t key) noexcept {
+	mEntries.erase(key);
+}
+
+GLPP_DECL
+void TextureAtlas::clear() noexcept {
+	for(Layer& layer : mLayers)
+		evict(layer);
+}
+
+GLPP_DECL
+void TextureAtlas::evict(Layer& layer) noexcept {
+	unsigned layerIndex = unsigned(&layer - mLayers.data());
+	for(uint64_t key : layer.keys) {
+		// Skip keys that were erased or re-inserted into another layer since
+		auto iter = mEntries.find(key);
+		if(iter != mEntries.end() && iter->second.layer == layerIndex) {
+			mEntries.erase(iter);
+			mStats.evictions++;
+		}
+	}
+	layer.keys.clear();
+	layer.packer.reset(mSize, mSize);
+	layer.lastUsed = 0;
+}
+
+GLPP_DECL
+void TextureAtlas::update() noexcept {
+	if(mDirty) {
+		if(mTexture.levels() > 1) mTexture.generateMipmaps();
+		mDirty = false;
+	}
+	mFrame++;
+}
+
+} // namespace gl
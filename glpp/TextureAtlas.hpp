@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Enums.hpp"
+#include "Texture.hpp"
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace gl {
+
+namespace detail {
+
+// Bottom-left skyline rectangle packer
+class Skyline {
+	struct Node {
+		GLsizei x, y, width;
+	};
+	GLsizei           mWidth  = 0;
+	GLsizei           mHeight = 0;
+	std::vector<Node> mNodes;
+public:
+	void reset(GLsizei width, GLsizei height) noexcept;
+	/// False if there's no room for w×h
+	bool allocate(GLsizei w, GLsizei h, GLsizei& x, GLsizei& y) noexcept;
+};
+
+} // namespace detail
+
+/// Packs many small images (icons, glyphs, ...) into the layers of one Texture2DArray, so drawing them doesn't switch textures.
+/// Images are looked up by a key of your choice, each gets a padded border of repeated edge texels so filtering and mip levels don't bleed into neighbours.
+/// When all layers are full, the least recently used layer is cleared as a whole and reused.
+///
+///     gl::TextureAtlas icons(gl::RGBA8, 1024, 4, 3);
+///     auto const* icon = icons.find(id);
+///     if(!icon) icon = icons.insert(id, w, h, gl::RGBA, gl::UNSIGNED_BYTE, pixels);
+///     ... draw with icon->uv and icon->layer
+///     icons.update(); // Once per frame
+class TextureAtlas {
+public:
+	struct Region {
+		unsigned layer;
+		float    uv[4];         // u0, v0, u1, v1 of the image, without the border
+		GLsizei  x, y;          // Of the image in level 0, without the border
+		GLsizei  width, height;
+	};
+	struct Stats {
+		size_t hits      = 0;
+		size_t misses    = 0;
+		size_t inserts   = 0;
+		size_t evictions = 0; // Entries dropped to make room
+	};
+
+	TextureAtlas(std::nullptr_t) noexcept;
+	/// `size`² texels per layer. `padding` is the border around each image, by default enough for one texel in the smallest mip level.
+	TextureAtlas(SizedImageFormat format, GLsizei size, GLsizei layers, GLsizei levels = 1, GLsizei padding = -1) noexcept;
+
+	TextureAtlas(TextureAtlas&& other) noexcept = default;
+	TextureAtlas& operator=(TextureAtlas&& other) noexcept = default;
+	TextureAtlas(TextureAtlas const& other) = delete;
+	TextureAtlas& operator=(TextureAtlas const& other) = delete;
+
+	void init(SizedImageFormat format, GLsizei size, GLsizei layers, GLsizei levels = 1, GLsizei padding = -1) noexcept;
+	void destroy() noexcept;
+
+	/// The region of `key` if it's in the atlas, and marks it as used this frame
+	Region const* find(uint64_t key) noexcept;
+	/// Packs and uploads a tightly packed image. Returns nullptr if it's bigger than a layer, or if all layers were used this frame.
+	/// The pointer stays valid until the entry is evicted or erased.
+	Region const* insert(uint64_t key, GLsizei width, GLsizei height, UnsizedImageFormat format, BasicType pxtype, void const* pixels);
+	/// Forgets `key`, its space is reused once its layer gets evicted
+	void erase(uint64_t key) noexcept;
+	void clear() noexcept;
+
+	/// Regenerates the mip levels if anything was inserted and starts a new frame for the LRU bookkeeping
+	void update() noexcept;
+
+	Texture2DArray&       texture()       noexcept { return mTexture; }
+	Texture2DArray const& texture() const noexcept { return mTexture; }
+	GLsizei               layers()  const noexcept { return GLsizei(mLayers.size()); }
+	size_t                size()    const noexcept { return mEntries.size(); }
+	Stats const&          stats()   const noexcept { return mStats; }
+
+private:
+	struct Layer {
+		detail::Skyline       packer;
+		uint64_t              lastUsed = 0; // Frame
+		std::vector<uint64_t> keys;         // Entries placed in this layer, including erased ones
+	};
+
+	Texture2DArray                         mTexture;
+	GLsizei                                mSize      = 0;
+	GLsizei                                mPadding   = 0;
+	GLsizei                                mAlignment = 1; // Of positions and sizes, so every mip level starts on whole texels
+	std::vector<Layer>                     mLayers;
+	std::unordered_map<uint64_t, Region>   mEntries;
+	std::vector<uint8_t>                   mScratch;       // Image with its border
+	uint64_t                               mFrame     = 1;
+	bool                                   mDirty     = false;
+	Stats                                  mStats;
+
+	void evict(Layer& layer) noexcept;
+};
+
+} // namespace gl
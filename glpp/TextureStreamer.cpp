@@ -0,0 +1,241 @@
+#include "TextureStreamer.hpp"
+
+#include <cstring>
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+namespace detail {
+
+// Which of glTextureSubImage1D/2D/3D the texture takes
+GLPP_DECL
+unsigned textureDimensions(unsigned texture) noexcept {
+	switch(textureParameter(texture, GL_TEXTURE_TARGET)) {
+		case GL_TEXTURE_1D:        return 1;
+		case GL_TEXTURE_1D_ARRAY:
+		case GL_TEXTURE_2D:
+		case GL_TEXTURE_RECTANGLE: return 2;
+		default:                   return 3;
+	}
+}
+
+} // namespace detail
+
+GLPP_DECL
+TextureStreamer::TextureStreamer(std::nullptr_t) noexcept :
+	mBuffer(nullptr)
+{}
+
+GLPP_DECL
+TextureStreamer::TextureStreamer(size_t capacity) noexcept :
+	TextureStreamer(nullptr)
+{
+	init(capacity);
+}
+
+GLPP_DECL
+void TextureStreamer::init(size_t capacity) noexcept {
+	destroy();
+
+	mBuffer.init();
+	mBuffer.storage(STORAGE_MAP_WRITE_BIT | STORAGE_MAP_PERSISTENT_BIT | STORAGE_MAP_COHERENT_BIT, capacity);
+	mMapping  = mBuffer.map(0, capacity, MAP_WRITE_BIT | MAP_PERSISTENT_BIT | MAP_COHERENT_BIT);
+	mCapacity = capacity;
+}
+
+GLPP_DECL
+void TextureStreamer::destroy() noexcept {
+	mSlots.clear();
+	mMapping.reset(); // Unmap before the buffer goes away
+	mBuffer.destroy();
+	mCapacity = mHead = mInFlight = 0;
+	mStats    = {};
+}
+
+GLPP_DECL
+auto TextureStreamer::begin(
+	unsigned texture,
+	GLsizei level,
+	GLsizei xoff, GLsizei width,
+	UnsizedImageFormat format, BasicType pxtype) noexcept
+	-> Upload
+{
+	GLsizei offset[3] = { xoff, 0, 0 }, size[3] = { width, 1, 1 };
+	return begin(texture, 1, level, offset, size, format, pxtype);
+}
+GLPP_DECL
+auto TextureStreamer::begin(
+	unsigned texture,
+	GLsizei level,
+	GLsizei xoff, GLsizei yoff, GLsizei width, GLsizei height,
+	UnsizedImageFormat format, BasicType pxtype) noexcept
+	-> Upload
+{
+	GLsizei offset[3] = { xoff, yoff, 0 }, size[3] = { width, height, 1 };
+	return begin(texture, 2, level, offset, size, format, pxtype);
+}
+GLPP_DECL
+auto TextureStreamer::begin(
+	unsigned texture,
+	GLsizei level,
+	GLsizei xoff, GLsizei yoff, GLsizei zoff, GLsizei width, GLsizei height, GLsizei depth,
+	UnsizedImageFormat format, BasicType pxtype) noexcept
+	-> Upload
+{
+	GLsizei offset[3] = { xoff, yoff, zoff }, size[3] = { width, height, depth };
+	return begin(texture, 3, level, offset, size, format, pxtype);
+}
+
+GLPP_DECL
+auto TextureStreamer::beginLevel(unsigned texture, GLsizei level, UnsizedImageFormat format, BasicType pxtype) noexcept
+	-> Upload
+{
+	GLsizei offset[3] = { 0, 0, 0 };
+	GLsizei size[3] = {
+		detail::textureLevelParameter(texture, level, GL_TEXTURE_WIDTH),
+		detail::textureLevelParameter(texture, level, GL_TEXTURE_HEIGHT),
+		detail::textureLevelParameter(texture, level, GL_TEXTURE_DEPTH),
+	};
+	if(detail::textureParameter(texture, GL_TEXTURE_TARGET) == GL_TEXTURE_CUBE_MAP)
+		size[2] = 6; // DSA treats cubemaps as 6 layers
+	unsigned dimensions = detail::textureDimensions(texture);
+	return begin(texture, dimensions, level, offset, size, format, pxtype);
+}
+
+GLPP_DECL
+auto TextureStreamer::begin(unsigned texture, unsigned dimensions, GLsizei level, GLsizei const* offset, GLsizei const* size, UnsizedImageFormat format, BasicType pxtype) noexcept
+	-> Upload
+{
+	size_t bytes = size_t(size[0]) * size[1] * size[2] * componentCount(format) * sizeOf(pxtype);
+	if(bytes == 0) return {};
+
+	// 16 bytes satisfy the alignment of every pixel type
+	if(bytes + 16 > mCapacity) return {};
+	size_t ringOffset, needed;
+	detail::ringPlacement(mHead, mCapacity, bytes, 16, ringOffset, needed);
+	if(needed > mCapacity) {
+		// Wrapping around would waste too much, start over at 0 once everything in the ring is done
+		if(!reclaim(mCapacity)) return {};
+		mHead = 0;
+		detail::ringPlacement(mHead, mCapacity, bytes, 16, ringOffset, needed);
+	}
+	else if(!reclaim(needed)) return {};
+
+	Slot& slot = mSlots.emplace_back();
+	slot.texture    = texture;
+	slot.dimensions = dimensions;
+	slot.level      = level;
+	std::memcpy(slot.offset, offset, sizeof(slot.offset));
+	std::memcpy(slot.size, size, sizeof(slot.size));
+	slot.format     = format;
+	slot.type       = pxtype;
+	slot.ringOffset = ringOffset;
+	slot.needed     = needed;
+	slot.state.store(kWriting, std::memory_order_relaxed);
+
+	mHead      = ringOffset + bytes;
+	mInFlight += needed;
+
+	Upload result;
+	result.mSlot  = &slot;
+	result.mData  = static_cast<uint8_t*>(mMapping.get()) + ringOffset;
+	result.mBytes = bytes;
+	return result;
+}
+
+GLPP_DECL
+void TextureStreamer::commit(Upload const& upload) noexcept {
+	upload.mSlot->state.store(kCommitted, std::memory_order_release);
+}
+
+GLPP_DECL
+void TextureStreamer::cancel(Upload const& upload) noexcept {
+	upload.mSlot->state.store(kCancelled, std::memory_order_release);
+}
+
+GLPP_DECL
+void TextureStreamer::texSubimage(
+	unsigned texture,
+	GLsizei level,
+	GLsizei xoff, GLsizei yoff, GLsizei zoff, GLsizei width, GLsizei height, GLsizei depth,
+	UnsizedImageFormat format, BasicType pxtype, void const* pixels) noexcept
+{
+	GLsizei  offset[3]  = { xoff, yoff, zoff }, size[3] = { width, height, depth };
+	unsigned dimensions = detail::textureDimensions(texture);
+	if(Upload upload = begin(texture, dimensions, level, offset, size, format, pxtype)) {
+		std::memcpy(upload.data(), pixels, upload.bytes());
+		commit(upload);
+		return;
+	}
+
+	GLint unpackAlignment = 0;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	detail::textureSubImage(dimensions, texture, level, offset, size, format, pxtype, pixels);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+}
+
+GLPP_DECL
+size_t TextureStreamer::update() noexcept {
+	size_t issued = 0;
+	GLint  unpackAlignment = 0, unpackBuffer = 0;
+	for(Slot& slot : mSlots) {
+		if(slot.state.load(std::memory_order_acquire) != kCommitted) continue;
+
+		if(issued++ == 0) {
+			glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+			glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpackBuffer);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mBuffer);
+		}
+		detail::textureSubImage(slot.dimensions, slot.texture, slot.level, slot.offset, slot.size, slot.format, slot.type, reinterpret_cast<void const*>(slot.ringOffset));
+		slot.sync = fence();
+		slot.state.store(kIssued, std::memory_order_relaxed);
+
+		mStats.uploads++;
+		mStats.bytes += size_t(slot.size[0]) * slot.size[1] * slot.size[2] * componentCount(slot.format) * sizeOf(slot.type);
+	}
+	if(issued > 0) {
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GLuint(unpackBuffer));
+		glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+	}
+	return issued;
+}
+
+GLPP_DECL
+size_t TextureStreamer::pending() const noexcept {
+	size_t result = 0;
+	for(Slot const& slot : mSlots) {
+		SlotState state = slot.state.load(std::memory_order_relaxed);
+		result += state == kWriting || state == kCommitted;
+	}
+	return result;
+}
+
+GLPP_DECL
+bool TextureStreamer::reclaim(size_t bytes) noexcept {
+	while(mCapacity - mInFlight < bytes) {
+		Slot& oldest = mSlots.front();
+		SlotState state = oldest.state.load(std::memory_order_acquire);
+		if(state == kCommitted) {
+			update();
+			state = kIssued;
+		}
+		if(state == kWriting) {
+			mStats.blocked++;
+			return false;
+		}
+		if(state == kIssued && !oldest.sync.signaled()) {
+			mStats.stalls++;
+			(void) oldest.sync.waitClient();
+		}
+		mInFlight -= oldest.needed;
+		mSlots.pop_front();
+	}
+	return true;
+}
+
+} // namespace gl
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Buffer.hpp"
+#include "Enums.hpp"
+#include "Sync.hpp"
+#include "Texture.hpp"
+
+#include <GL/glew.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace gl {
+
+/// Streams texture data through a persistently mapped PIXEL_UNPACK_BUFFER ring, so the driver never copies from client memory.
+/// begin() reserves room for one region of one mip level on the GL thread, any thread can then write the pixels and commit() them.
+/// update() issues glTextureSubImage* with buffer offsets for everything committed and fences each upload on its own,
+/// the ring space is reused once the GPU got there.
+///
+///     auto upload = streamer.beginLevel(texture, 3, RGBA, UNSIGNED_BYTE);
+///     pool.push([&streamer, upload] {
+///         decode(upload.data(), upload.bytes());
+///         streamer.commit(upload);
+///     });
+///     ...
+///     streamer.update(); // Once per frame on the GL thread
+///
+/// Pixels are tightly packed (GL_UNPACK_ALIGNMENT 1), with no row length or skip set.
+/// Committed uploads are issued in no particular order, don't stream to the same region twice without an update() in between.
+class TextureStreamer {
+	struct Slot;
+public:
+	struct Stats {
+		size_t uploads = 0; // glTextureSubImage* calls issued by update()
+		size_t bytes   = 0; // Bytes that went through the ring
+		size_t stalls  = 0; // begin() calls that had to wait for the GPU to free ring space
+		size_t blocked = 0; // begin() calls that failed because the oldest upload wasn't committed yet
+	};
+
+	/// Ring space for one texture region, copyable so it can be handed to a worker
+	class Upload {
+		friend class TextureStreamer;
+		Slot*  mSlot  = nullptr;
+		void*  mData  = nullptr;
+		size_t mBytes = 0;
+	public:
+		void*  data()  const noexcept { return mData; }
+		size_t bytes() const noexcept { return mBytes; }
+		/// False if begin() couldn't get ring space, upload another way or try again after the next update()
+		explicit operator bool() const noexcept { return mSlot != nullptr; }
+	};
+
+	TextureStreamer(std::nullptr_t) noexcept;
+	explicit TextureStreamer(size_t capacity) noexcept;
+
+	TextureStreamer(TextureStreamer&& other) noexcept = delete;
+	TextureStreamer& operator=(TextureStreamer&& other) noexcept = delete;
+	TextureStreamer(TextureStreamer const& other) = delete;
+	TextureStreamer& operator=(TextureStreamer const& other) = delete;
+
+	void init(size_t capacity) noexcept;
+	/// Uploads that weren't committed yet are dropped, their data pointers become invalid
+	void destroy() noexcept;
+
+	/// GL thread. Reserves ring space for a region of `level`, waits for the GPU if the ring is full of issued uploads.
+	[[nodiscard]] Upload begin(
+		unsigned texture,
+		GLsizei level,
+		GLsizei xoff, GLsizei width,
+		UnsizedImageFormat format, BasicType pxtype) noexcept;
+	[[nodiscard]] Upload begin(
+		unsigned texture,
+		GLsizei level,
+		GLsizei xoff, GLsizei yoff, GLsizei width, GLsizei height,
+		UnsizedImageFormat format, BasicType pxtype) noexcept;
+	[[nodiscard]] Upload begin(
+		unsigned texture,
+		GLsizei level,
+		GLsizei xoff, GLsizei yoff, GLsizei zoff, GLsizei width, GLsizei height, GLsizei depth,
+		UnsizedImageFormat format, BasicType pxtype) noexcept;
+	/// GL thread. Reserves ring space for all of `level` (all layers for arrays and cubemaps), e.g. to stream the smallest levels first
+	[[nodiscard]] Upload beginLevel(unsigned texture, GLsizei level, UnsizedImageFormat format, BasicType pxtype) noexcept;
+
+	/// Any thread. The data is written, issue it with the next update()
+	void commit(Upload const& upload) noexcept;
+	/// Any thread. Gives the ring space back without uploading anything
+	void cancel(Upload const& upload) noexcept;
+
+	/// GL thread. begin(), copy and commit(), or a plain glTextureSubImage* if the ring is full. Unused dimensions are 0 for offsets and 1 for sizes.
+	void texSubimage(
+		unsigned texture,
+		GLsizei level,
+		GLsizei xoff, GLsizei yoff, GLsizei zoff, GLsizei width, GLsizei height, GLsizei depth,
+		UnsizedImageFormat format, BasicType pxtype, void const* pixels) noexcept;
+
+	/// GL thread. Issues all committed uploads, returns how many. The PIXEL_UNPACK_BUFFER binding and GL_UNPACK_ALIGNMENT are restored afterwards
+	size_t update() noexcept;
+
+	Stats const& stats() const noexcept { return mStats; }
+	size_t capacity() const noexcept { return mCapacity; }
+	/// Uploads that weren't issued yet
+	size_t pending() const noexcept;
+
+private:
+	enum SlotState : uint8_t {
+		kWriting,
+		kCommitted,
+		kCancelled,
+		kIssued
+	};
+	struct Slot {
+		unsigned               texture;
+		unsigned               dimensions;
+		GLsizei                level;
+		GLsizei                offset[3];
+		GLsizei                size[3];
+		UnsizedImageFormat     format;
+		BasicType              type;
+		size_t                 ringOffset;
+		size_t                 needed; // Ring bytes including padding and space wasted by wrapping around
+		std::atomic<SlotState> state;
+		Sync                   sync;   // Set once issued
+	};
+
+	PixelUnpackBuffer         mBuffer;
+	detail::BufferMapping<>   mMapping;
+	size_t                    mCapacity = 0;
+	size_t                    mHead     = 0;
+	size_t                    mInFlight = 0;
+	std::deque<Slot>          mSlots;   // In ring order, references stay valid while workers write
+	Stats                     mStats;
+
+	Upload begin(unsigned texture, unsigned dimensions, GLsizei level, GLsizei const* offset, GLsizei const* size, UnsizedImageFormat format, BasicType pxtype) noexcept;
+	// Frees slots from the front until `bytes` are available, false if an uncommitted upload is in the way
+	bool reclaim(size_t bytes) noexcept;
+};
+
+} // namespace gl
@@ -0,0 +1,106 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+GLPP_DECL
+ThreadPool::ThreadPool(unsigned threads) {
+	if(threads == 0)
+		threads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	mThreads.reserve(threads);
+	for(unsigned i = 0; i < threads; i++)
+		mThreads.emplace_back([this] { work(); });
+}
+
+GLPP_DECL
+ThreadPool::~ThreadPool() noexcept {
+	{
+		std::lock_guard lock(mMutex);
+		mStopping = true;
+	}
+	mWake.notify_all();
+	for(std::thread& thread : mThreads)
+		thread.join();
+}
+
+GLPP_DECL
+void ThreadPool::push(std::function<void()> task) {
+	{
+		std::lock_guard lock(mMutex);
+		mTasks.push_back(std::move(task));
+	}
+	mWake.notify_one();
+}
+
+GLPP_DECL
+void ThreadPool::parallelFor(size_t count, std::function<void(size_t begin, size_t end)> const& fn, size_t grain) {
+	grain = std::max<size_t>(grain, 1);
+	size_t chunks = (count + grain - 1) / grain;
+	if(chunks == 0) return;
+	if(chunks == 1 || mThreads.empty()) {
+		fn(0, count);
+		return;
+	}
+
+	// Shared, because helpers that only get to run after the last chunk still look at it
+	struct Shared {
+		std::atomic<size_t>                                   next { 0 };
+		std::atomic<size_t>                                   done { 0 };
+		std::mutex                                            mutex;
+		std::condition_variable                               finished;
+		std::function<void(size_t begin, size_t end)> const* fn;
+	};
+	auto shared = std::make_shared<Shared>();
+	shared->fn = &fn;
+
+	auto run = [shared, chunks, count, grain] {
+		for(size_t chunk; (chunk = shared->next++) < chunks;) {
+			(*shared->fn)(chunk * grain, std::min(count, (chunk + 1) * grain));
+			if(++shared->done == chunks) {
+				std::lock_guard lock(shared->mutex);
+				shared->finished.notify_all();
+			}
+		}
+	};
+	size_t helpers = std::min<size_t>(mThreads.size(), chunks - 1);
+	for(size_t i = 0; i < helpers; i++)
+		push(run);
+	run();
+
+	std::unique_lock lock(shared->mutex);
+	shared->finished.wait(lock, [&] { return shared->done == chunks; });
+}
+
+GLPP_DECL
+void ThreadPool::wait() {
+	std::unique_lock lock(mMutex);
+	mIdle.wait(lock, [this] { return mTasks.empty() && mRunning == 0; });
+}
+
+GLPP_DECL
+void ThreadPool::work() {
+	std::unique_lock lock(mMutex);
+	while(true) {
+		mWake.wait(lock, [this] { return mStopping || !mTasks.empty(); });
+		if(mTasks.empty()) return; // Stopping
+
+		std::function<void()> task = std::move(mTasks.front());
+		mTasks.pop_front();
+		mRunning++;
+		lock.unlock();
+		task();
+		lock.lock();
+		mRunning--;
+		if(mTasks.empty() && mRunning == 0)
+			mIdle.notify_all();
+	}
+}
+
+} // namespace gl
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gl {
+
+/// A fixed set of worker threads for CPU side work like building mip chains, no GL calls happen on them.
+///
+///     gl::ThreadPool pool;
+///     pool.parallelFor(rows, [&](size_t begin, size_t end) { ... });
+class ThreadPool {
+public:
+	/// 0 threads uses one less than the hardware has, the thread calling parallelFor() works as well
+	explicit ThreadPool(unsigned threads = 0);
+	/// Finishes the queued tasks first
+	~ThreadPool() noexcept;
+
+	ThreadPool(ThreadPool&& other) noexcept = delete;
+	ThreadPool& operator=(ThreadPool&& other) noexcept = delete;
+	ThreadPool(ThreadPool const& other) = delete;
+	ThreadPool& operator=(ThreadPool const& other) = delete;
+
+	void push(std::function<void()> task);
+	/// Calls fn(begin, end) for chunks of `grain` indices covering [0, count) and returns once all of them ran.
+	/// Can be called from a task, the caller takes chunks itself so it never waits on a busy pool.
+	void parallelFor(size_t count, std::function<void(size_t begin, size_t end)> const& fn, size_t grain = 1);
+	/// Blocks until the queue is empty and no task is running
+	void wait();
+
+	unsigned size() const noexcept { return unsigned(mThreads.size()); }
+
+private:
+	std::vector<std::thread>          mThreads;
+	std::deque<std::function<void()>> mTasks;
+	std::mutex                        mMutex;
+	std::condition_variable           mWake; // Workers wait for tasks
+	std::condition_variable           mIdle; // wait() waits for the queue to drain
+	size_t                            mRunning  = 0;
+	bool                              mStopping = false;
+
+	void work();
+};
+
+} // namespace gl
@@ -0,0 +1,131 @@
+#include "Uniform.hpp"
+
+#include <string>
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+namespace detail {
+
+GLPP_DECL
+void programUniform(unsigned program, int location, GLsizei count, float const* values) noexcept {
+	glProgramUniform1fv(program, location, count, values);
+}
+GLPP_DECL
+void programUniform(unsigned program, int location, GLsizei count, int const* values) noexcept {
+	glProgramUniform1iv(program, location, count, values);
+}
+GLPP_DECL
+void programUniform(unsigned program, int location, GLsizei count, unsigned const* values) noexcept {
+	glProgramUniform1uiv(program, location, count, values);
+}
+GLPP_DECL
+void programUniform(unsigned program, int location, GLsizei count, double const* values) noexcept {
+	glProgramUniform1dv(program, location, count, values);
+}
+
+template<class T, size_t N> GLPP_DECL
+void programUniform(unsigned program, int location, GLsizei count, Vector<T, N> const* values) noexcept {
+	T const* v = values->v;
+	if constexpr(std::is_same_v<T, float>) {
+		if constexpr(N == 2) glProgramUniform2fv(program, location, count, v);
+		if constexpr(N == 3) glProgramUniform3fv(program, location, count, v);
+		if constexpr(N == 4) glProgramUniform4fv(program, location, count, v);
+	}
+	else if constexpr(std::is_same_v<T, int>) {
+		if constexpr(N == 2) glProgramUniform2iv(program, location, count, v);
+		if constexpr(N == 3) glProgramUniform3iv(program, location, count, v);
+		if constexpr(N == 4) glProgramUniform4iv(program, location, count, v);
+	}
+	else if constexpr(std::is_same_v<T, unsigned>) {
+		if constexpr(N == 2) glProgramUniform2uiv(program, location, count, v);
+		if constexpr(N == 3) glProgramUniform3uiv(program, location, count, v);
+		if constexpr(N == 4) glProgramUniform4uiv(program, location, count, v);
+	}
+	else if constexpr(std::is_same_v<T, double>) {
+		if constexpr(N == 2) glProgramUniform2dv(program, location, count, v);
+		if constexpr(N == 3) glProgramUniform3dv(program, location, count, v);
+		if constexpr(N == 4) glProgramUniform4dv(program, location, count, v);
+	}
+}
+
+template void programUniform(unsigned, int, GLsizei, Vector<float, 2> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Vector<float, 3> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Vector<float, 4> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Vector<int, 2> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Vector<int, 3> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Vector<int, 4> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Vector<unsigned, 2> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Vector<unsigned, 3> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Vector<unsigned, 4> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Vector<double, 2> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Vector<double, 3> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Vector<double, 4> const*) noexcept;
+
+template<class T, size_t Cols, size_t Rows> GLPP_DECL
+void programUniform(unsigned program, int location, GLsizei count, Matrix<T, Cols, Rows> const* values) noexcept {
+	T const* v = values->columns[0].v;
+	if constexpr(std::is_same_v<T, float>) {
+		if constexpr(Cols == 2 && Rows == 2) glProgramUniformMatrix2fv  (program, location, count, GL_FALSE, v);
+		if constexpr(Cols == 2 && Rows == 3) glProgramUniformMatrix2x3fv(program, location, count, GL_FALSE, v);
+		if constexpr(Cols == 2 && Rows == 4) glProgramUniformMatrix2x4fv(program, location, count, GL_FALSE, v);
+		if constexpr(Cols == 3 && Rows == 2) glProgramUniformMatrix3x2fv(program, location, count, GL_FALSE, v);
+		if constexpr(Cols == 3 && Rows == 3) glProgramUniformMatrix3fv  (program, location, count, GL_FALSE, v);
+		if constexpr(Cols == 3 && Rows == 4) glProgramUniformMatrix3x4fv(program, location, count, GL_FALSE, v);
+		if constexpr(Cols == 4 && Rows == 2) glProgramUniformMatrix4x2fv(program, location, count, GL_FALSE, v);
+		if constexpr(Cols == 4 && Rows == 3) glProgramUniformMatrix4x3fv(program, location, count, GL_FALSE, v);
+		if constexpr(Cols == 4 && Rows == 4) glProgramUniformMatrix4fv  (program, location, count, GL_FALSE, v);
+	}
+	else if constexpr(std::is_same_v<T, double>) {
+		if constexpr(Cols == 2 && Rows == 2) glProgramUniformMatrix2dv  (program, location, count, GL_FALSE, v);
+		if constexpr(Cols == 2 && Rows == 3) glProgramUniformMatrix2x3dv(program, location, count, GL_FALSE, v);
+		if constexpr(Cols == 2 && Rows == 4) glProgramUniformMatrix2x4dv(program, location, count, GL_FALSE, v);
+		if constexpr(Cols == 3 && Rows == 2) glProgramUniformMatrix3x2dv(program, location, count, GL_FALSE, v);
+		if constexpr(Cols == 3 && Rows == 3) glProgramUniformMatrix3dv  (program, location, count, GL_FALSE, v);
+		if constexpr(Cols == 3 && Rows == 4) glProgramUniformMatrix3x4dv(program, location, count, GL_FALSE, v);
+		if constexpr(Cols == 4 && Rows == 2) glProgramUniformMatrix4x2dv(program, location, count, GL_FALSE, v);
+		if constexpr(Cols == 4 && Rows == 3) glProgramUniformMatrix4x3dv(program, location, count, GL_FALSE, v);
+		if constexpr(Cols == 4 && Rows == 4) glProgramUniformMatrix4dv  (program, location, count, GL_FALSE, v);
+	}
+}
+
+template void programUniform(unsigned, int, GLsizei, Matrix<float, 2, 2> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<float, 2, 3> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<float, 2, 4> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<float, 3, 2> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<float, 3, 3> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<float, 3, 4> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<float, 4, 2> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<float, 4, 3> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<float, 4, 4> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<double, 2, 2> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<double, 2, 3> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<double, 2, 4> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<double, 3, 2> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<double, 3, 3> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<double, 3, 4> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<double, 4, 2> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<double, 4, 3> const*) noexcept;
+template void programUniform(unsigned, int, GLsizei, Matrix<double, 4, 4> const*) noexcept;
+
+GLPP_DECL
+void uniformElementLocations(unsigned program, const char* name, int* locations, size_t count) noexcept {
+	std::string element = name;
+	if(element.size() > 3 && element.compare(element.size() - 3, 3, "[0]") == 0)
+		element.resize(element.size() - 3); // Like GL reports arrays
+	element += '[';
+	size_t prefix = element.size();
+	for(size_t i = 1; i < count; i++) {
+		element.resize(prefix);
+		element += std::to_string(i);
+		element += ']';
+		locations[i] = glGetUniformLocation(program, element.c_str());
+	}
+}
+
+} // namespace detail
+
+} // namespace gl
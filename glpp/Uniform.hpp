@@ -0,0 +1,184 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#if __has_include(<glm/fwd.hpp>)
+#include <glm/fwd.hpp>
+#define GLPP_HAS_GLM
+#endif
+
+namespace gl {
+
+/// Plain vector and matrix types for uniforms, in case glm isn't around. Matrices are column major like in GLSL:
+///
+///     gl::Matrix<float, 4> identity = { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 };
+template<class T, size_t N>
+struct Vector {
+	T v[N];
+
+	constexpr T&       operator[](size_t i)       noexcept { return v[i]; }
+	constexpr T const& operator[](size_t i) const noexcept { return v[i]; }
+};
+
+template<class T, size_t Cols, size_t Rows = Cols>
+struct Matrix {
+	Vector<T, Rows> columns[Cols];
+
+	constexpr Vector<T, Rows>&       operator[](size_t column)       noexcept { return columns[column]; }
+	constexpr Vector<T, Rows> const& operator[](size_t column) const noexcept { return columns[column]; }
+};
+
+/// Counts UniformHandle::set() calls of the current thread
+struct UniformStats {
+	size_t uploads = 0; // Calls that reached glProgramUniform*
+	size_t skipped = 0; // Calls that didn't, because the value was already set
+};
+
+namespace detail {
+
+inline thread_local UniformStats tUniformStats;
+
+// glProgramUniform*v for every type GLSL has a uniform for. `count` is the number of array elements.
+void programUniform(unsigned program, int location, GLsizei count, float    const* values) noexcept;
+void programUniform(unsigned program, int location, GLsizei count, int      const* values) noexcept;
+void programUniform(unsigned program, int location, GLsizei count, unsigned const* values) noexcept;
+void programUniform(unsigned program, int location, GLsizei count, double   const* values) noexcept;
+/// T is float, int, unsigned or double, N is 2, 3 or 4
+template<class T, size_t N>
+void programUniform(unsigned program, int location, GLsizei count, Vector<T, N> const* values) noexcept;
+/// T is float or double, Cols and Rows are 2, 3 or 4
+template<class T, size_t Cols, size_t Rows>
+void programUniform(unsigned program, int location, GLsizei count, Matrix<T, Cols, Rows> const* values) noexcept;
+
+// Locations of name[1] to name[count - 1], GLSL doesn't promise consecutive locations for array elements
+void uniformElementLocations(unsigned program, const char* name, int* locations, size_t count) noexcept;
+
+#ifdef GLPP_HAS_GLM
+	// glm's packed types have the same layout as Vector and Matrix
+	template<glm::length_t N, class T>
+	void programUniform(unsigned program, int location, GLsizei count, glm::vec<N, T, glm::defaultp> const* values) noexcept {
+		programUniform(program, location, count, reinterpret_cast<Vector<T, N> const*>(values));
+	}
+	template<glm::length_t Cols, glm::length_t Rows, class T>
+	void programUniform(unsigned program, int location, GLsizei count, glm::mat<Cols, Rows, T, glm::defaultp> const* values) noexcept {
+		programUniform(program, location, count, reinterpret_cast<Matrix<T, Cols, Rows> const*>(values));
+	}
+#endif
+
+} // namespace detail
+
+/// The current thread's counters, reset them once per frame:
+///
+///     gl::UniformStats lastFrame = gl::resetUniformStats();
+inline UniformStats uniformStats() noexcept { return detail::tUniformStats; }
+inline UniformStats resetUniformStats() noexcept { UniformStats result = detail::tUniformStats; detail::tUniformStats = {}; return result; }
+
+/// A uniform location together with the last value set through it, see Program::uniformHandle().
+/// set() only calls glProgramUniform* if the value changed, so the program doesn't need to be bound.
+/// T is a scalar, Vector, Matrix or glm type, T[N] is an array of them (e.g. a bone palette).
+/// The shadow doesn't know about values set any other way, call invalidate() after doing that.
+/// Resolve handles again after relinking the program.
+template<class T>
+class UniformHandle {
+	static_assert(std::is_trivially_copyable_v<T>);
+
+	unsigned mProgram  = 0;
+	int      mLocation = -1;
+	bool     mCurrent  = false; // Whether mValue is what the program has
+	T        mValue;
+
+public:
+	UniformHandle() noexcept = default;
+	UniformHandle(unsigned program, int location) noexcept :
+		mProgram(program), mLocation(location)
+	{}
+
+	void set(T const& value) noexcept {
+		if(mLocation < 0) return; // Not active
+		if(mCurrent && std::memcmp(&mValue, &value, sizeof(T)) == 0) {
+			detail::tUniformStats.skipped++;
+			return;
+		}
+		std::memcpy(&mValue, &value, sizeof(T));
+		mCurrent = true;
+		detail::programUniform(mProgram, mLocation, 1, &mValue);
+		detail::tUniformStats.uploads++;
+	}
+	UniformHandle& operator=(T const& value) noexcept { set(value); return *this; }
+
+	/// Makes the next set() upload
+	void invalidate() noexcept { mCurrent = false; }
+
+	/// The last value set(), meaningless before the first one
+	T const& value()    const noexcept { return mValue; }
+	int      location() const noexcept { return mLocation; }
+	explicit operator bool() const noexcept { return mLocation >= 0; }
+};
+
+/// Array version, only uploads the range of elements that changed
+template<class T, size_t N>
+class UniformHandle<T[N]> {
+	static_assert(std::is_trivially_copyable_v<T>);
+
+	unsigned mProgram      = 0;
+	int      mLocations[N] = {}; // Per element, -1 for the ones that aren't active
+	bool     mKnown[N]     = {}; // Whether mValues[i] is what the program has
+	T        mValues[N];
+
+	bool unchanged(size_t i, T const& value) const noexcept { return mKnown[i] && std::memcmp(&mValues[i], &value, sizeof(T)) == 0; }
+
+public:
+	UniformHandle() noexcept { std::fill(mLocations, mLocations + N, -1); }
+	/// `location` is that of element 0, the others are looked up as name[i]
+	UniformHandle(unsigned program, int location, const char* name) noexcept :
+		mProgram(program)
+	{
+		std::fill(mLocations, mLocations + N, -1);
+		mLocations[0] = location;
+		if(location >= 0) detail::uniformElementLocations(program, name, mLocations, N);
+	}
+	/// For explicit locations (layout(location = ...)), which are consecutive
+	UniformHandle(unsigned program, int location) noexcept :
+		mProgram(program)
+	{
+		for(size_t i = 0; i < N; i++) mLocations[i] = location < 0 ? -1 : location + int(i);
+	}
+
+	/// Sets elements [first, first + count)
+	void set(T const* values, size_t count, size_t first = 0) noexcept {
+		if(mLocations[0] < 0) return;
+		assert(first + count <= N);
+
+		// Shrink to the range that changed
+		size_t begin = first, end = first + count;
+		while(begin < end && unchanged(begin,   values[begin - first]))   begin++;
+		while(end > begin && unchanged(end - 1, values[end - 1 - first])) end--;
+		if(begin == end) {
+			detail::tUniformStats.skipped++;
+			return;
+		}
+
+		std::memcpy(&mValues[begin], &values[begin - first], (end - begin) * sizeof(T));
+		std::fill(mKnown + begin, mKnown + end, true);
+		// Uploads to the elements following `begin` too, even though their locations aren't mLocations[begin] + i
+		detail::programUniform(mProgram, mLocations[begin], GLsizei(end - begin), &mValues[begin]);
+		detail::tUniformStats.uploads++;
+	}
+	void set(T const (&values)[N]) noexcept { set(values, N); }
+	void set(size_t index, T const& value) noexcept { set(&value, 1, index); }
+
+	void invalidate() noexcept { std::fill(mKnown, mKnown + N, false); }
+
+	T const* values()   const noexcept { return mValues; }
+	size_t   size()     const noexcept { return N; }
+	int      location(size_t index = 0) const noexcept { return mLocations[index]; }
+	explicit operator bool() const noexcept { return mLocations[0] >= 0; }
+};
+
+} // namespace gl
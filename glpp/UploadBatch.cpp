@@ -0,0 +1,186 @@
+#include "UploadBatch.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#ifndef GLPP_DECL
+	#define GLPP_DECL
+#endif
+
+namespace gl {
+
+GLPP_DECL
+UploadBatch::UploadBatch(std::nullptr_t) noexcept :
+	mStaging(nullptr)
+{}
+
+GLPP_DECL
+UploadBatch::UploadBatch(size_t stagingBytes) noexcept :
+	UploadBatch(nullptr)
+{
+	init(stagingBytes);
+}
+
+GLPP_DECL
+void UploadBatch::init(size_t stagingBytes) noexcept {
+	destroy();
+	mStaging.init(stagingBytes);
+}
+
+GLPP_DECL
+void UploadBatch::destroy() noexcept {
+	mStaging.destroy();
+	mBufferWrites.clear();
+	mTextureWrites.clear();
+	mPendingBytes = 0;
+	mStats        = {};
+	mLastFlush    = {};
+}
+
+GLPP_DECL
+bool UploadBatch::reserve(size_t bytes, size_t alignment) noexcept {
+	if(bytes + alignment > mStaging.capacity())
+		return false;
+	if(!mStaging.fits(bytes, alignment))
+		submit(); // The ring is full of recorded writes, get them going
+	return true;
+}
+
+GLPP_DECL
+void UploadBatch::subdata(unsigned buffer, size_t offset, size_t bytes, void const* data) noexcept {
+	if(bytes == 0) return;
+
+	mStats.writes++;
+	if(!reserve(bytes, 1)) {
+		// Too big to stage, upload directly after what was recorded so far, which could otherwise overwrite it later
+		submit();
+		glNamedBufferSubData(buffer, offset, bytes, data);
+		mStats.calls++;
+		return;
+	}
+
+	auto region = mStaging.push(data, bytes);
+	mBufferWrites.push_back({ buffer, offset, region.offset, bytes });
+	mPendingBytes      += bytes;
+	mStats.bytesCopied += bytes;
+}
+
+GLPP_DECL
+void UploadBatch::texSubimage(
+	unsigned texture,
+	GLsizei level,
+	GLsizei xoff, GLsizei width,
+	UnsizedImageFormat format, BasicType pxtype, void const* pixels) noexcept
+{
+	texSubimage({ texture, 1, level, { xoff, 0, 0 }, { width, 1, 1 }, format, pxtype, 0, 0 }, pixels);
+}
+GLPP_DECL
+void UploadBatch::texSubimage(
+	unsigned texture,
+	GLsizei level,
+	GLsizei xoff, GLsizei yoff, GLsizei width, GLsizei height,
+	UnsizedImageFormat format, BasicType pxtype, void const* pixels) noexcept
+{
+	texSubimage({ texture, 2, level, { xoff, yoff, 0 }, { width, height, 1 }, format, pxtype, 0, 0 }, pixels);
+}
+GLPP_DECL
+void UploadBatch::texSubimage(
+	unsigned texture,
+	GLsizei level,
+	GLsizei xoff, GLsizei yoff, GLsizei zoff, GLsizei width, GLsizei height, GLsizei depth,
+	UnsizedImageFormat format, BasicType pxtype, void const* pixels) noexcept
+{
+	texSubimage({ texture, 3, level, { xoff, yoff, zoff }, { width, height, depth }, format, pxtype, 0, 0 }, pixels);
+}
+
+GLPP_DECL
+void UploadBatch::texSubimage(TextureWrite w, void const* pixels) noexcept {
+	if(w.size[0] <= 0 || w.size[1] <= 0 || w.size[2] <= 0) return;
+
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &w.unpackAlignment);
+
+	size_t rowBytes = size_t(w.size[0]) * componentCount(w.format) * sizeOf(w.type);
+	size_t rowPitch = (rowBytes + w.unpackAlignment - 1) / w.unpackAlignment * w.unpackAlignment;
+	size_t bytes    = rowPitch * (size_t(w.size[1]) * w.size[2] - 1) + rowBytes;
+
+	mStats.writes++;
+	if(!reserve(bytes, 16)) {
+		submit(); // Keeps the writes in order, see subdata()
+		detail::textureSubImage(w.dimensions, w.texture, w.level, w.offset, w.size, w.format, w.type, pixels);
+		mStats.calls++;
+		return;
+	}
+
+	// 16 bytes keep rows aligned for any GL_UNPACK_ALIGNMENT
+	w.stagingOffset = mStaging.push(pixels, bytes, 16).offset;
+	mTextureWrites.push_back(w);
+	mPendingBytes      += bytes;
+	mStats.bytesCopied += bytes;
+}
+
+GLPP_DECL
+void UploadBatch::submit() noexcept {
+	if(!mBufferWrites.empty()) {
+		// Sort by destination so neighbouring writes can be merged, unless that would reorder overlapping writes
+		std::vector<BufferWrite> sorted = mBufferWrites;
+		std::stable_sort(sorted.begin(), sorted.end(), [](BufferWrite const& a, BufferWrite const& b) {
+			return a.buffer < b.buffer || (a.buffer == b.buffer && a.offset < b.offset);
+		});
+		bool overlapping = false;
+		for(size_t i = 1; i < sorted.size() && !overlapping; i++) {
+			overlapping = sorted[i - 1].buffer == sorted[i].buffer && sorted[i - 1].offset + sorted[i - 1].size > sorted[i].offset;
+		}
+		std::vector<BufferWrite> const& writes = overlapping ? mBufferWrites : sorted;
+
+		BufferWrite run = writes.front();
+		for(size_t i = 1; i <= writes.size(); i++) {
+			if(i < writes.size()) {
+				BufferWrite const& w = writes[i];
+				if(w.buffer == run.buffer && w.offset == run.offset + run.size && w.stagingOffset == run.stagingOffset + run.size) {
+					run.size += w.size;
+					continue;
+				}
+			}
+
+			glCopyNamedBufferSubData(mStaging, run.buffer, run.stagingOffset, run.offset, run.size);
+			mStats.calls++;
+			if(i < writes.size()) run = writes[i];
+		}
+	}
+
+	if(!mTextureWrites.empty()) {
+		GLint originalAlignment = 0, originalBuffer = 0;
+		glGetIntegerv(GL_UNPACK_ALIGNMENT, &originalAlignment);
+		glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &originalBuffer);
+		GLint unpackAlignment = originalAlignment;
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mStaging);
+		for(TextureWrite const& w : mTextureWrites) {
+			if(w.unpackAlignment != unpackAlignment) {
+				unpackAlignment = w.unpackAlignment;
+				glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+			}
+			detail::textureSubImage(w.dimensions, w.texture, w.level, w.offset, w.size, w.format, w.type, reinterpret_cast<void const*>(w.stagingOffset));
+			mStats.calls++;
+		}
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GLuint(originalBuffer));
+		if(unpackAlignment != originalAlignment)
+			glPixelStorei(GL_UNPACK_ALIGNMENT, originalAlignment);
+	}
+
+	mStaging.retire();
+	mBufferWrites.clear();
+	mTextureWrites.clear();
+	mPendingBytes = 0;
+}
+
+GLPP_DECL
+auto UploadBatch::flush() noexcept
+	-> Stats
+{
+	submit();
+	mLastFlush = std::exchange(mStats, Stats{});
+	return mLastFlush;
+}
+
+} // namespace gl
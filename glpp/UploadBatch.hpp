@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Buffer.hpp"
+#include "Enums.hpp"
+#include "Texture.hpp"
+
+#include <GL/glew.h>
+
+#include <vector>
+
+namespace gl {
+
+/// Collects many small buffer and texture uploads in one persistently mapped staging buffer and submits them together.
+/// Recording only copies the data into the staging buffer, no GL calls are made until flush().
+/// flush() merges writes to adjacent ranges of the same buffer into single glCopyNamedBufferSubData calls
+/// and sources texture uploads from the staging buffer bound as PIXEL_UNPACK_BUFFER, restoring the previous binding afterwards.
+/// Texture data is expected to be laid out according to the current GL_UNPACK_ALIGNMENT, with no row length or skip set.
+class UploadBatch {
+public:
+	struct Stats {
+		size_t bytesCopied = 0; // Bytes that went through the staging buffer
+		size_t writes      = 0; // Number of recorded subdata/texSubimage calls
+		size_t calls       = 0; // Number of upload calls that were actually issued
+
+		size_t callsSaved() const noexcept { return writes - calls; }
+	};
+
+	UploadBatch(std::nullptr_t) noexcept;
+	explicit UploadBatch(size_t stagingBytes) noexcept;
+
+	UploadBatch(UploadBatch&& other) noexcept = default;
+	UploadBatch& operator=(UploadBatch&& other) noexcept = default;
+	UploadBatch(UploadBatch const& other) = delete;
+	UploadBatch& operator=(UploadBatch const& other) = delete;
+
+	void init(size_t stagingBytes) noexcept;
+	void destroy() noexcept;
+
+	void subdata(unsigned buffer, size_t offset, size_t bytes, void const* data) noexcept;
+	void subdata(BufferSlice const& slice, size_t offset, size_t bytes, void const* data) noexcept { subdata(slice.handle, slice.offset + offset, bytes, data); }
+	template<class T> void subdata(unsigned buffer, size_t offset_index, size_t count, T const* pData) noexcept { subdata(buffer, offset_index * sizeof(T), count * sizeof(T), (void const*)pData); }
+	template<class ContainerT> void subdata(unsigned buffer, size_t offset_index, ContainerT const& c) noexcept { subdata(buffer, offset_index, std::size(c), std::data(c)); }
+
+	void texSubimage(
+		unsigned texture,
+		GLsizei level,
+		GLsizei xoff, GLsizei width,
+		UnsizedImageFormat format, BasicType pxtype, void const* pixels) noexcept;
+	void texSubimage(
+		unsigned texture,
+		GLsizei level,
+		GLsizei xoff, GLsizei yoff, GLsizei width, GLsizei height,
+		UnsizedImageFormat format, BasicType pxtype, void const* pixels) noexcept;
+	void texSubimage(
+		unsigned texture,
+		GLsizei level,
+		GLsizei xoff, GLsizei yoff, GLsizei zoff, GLsizei width, GLsizei height, GLsizei depth,
+		UnsizedImageFormat format, BasicType pxtype, void const* pixels) noexcept;
+
+	/// Issues all recorded uploads and returns the statistics since the last flush()
+	Stats flush() noexcept;
+
+	Stats const& lastFlush() const noexcept { return mLastFlush; }
+	size_t pendingBytes() const noexcept { return mPendingBytes; }
+
+private:
+	struct BufferWrite {
+		unsigned buffer;
+		size_t   offset;
+		size_t   stagingOffset;
+		size_t   size;
+	};
+	struct TextureWrite {
+		unsigned           texture;
+		unsigned           dimensions;
+		GLsizei            level;
+		GLsizei            offset[3];
+		GLsizei            size[3];
+		UnsizedImageFormat format;
+		BasicType          type;
+		GLint              unpackAlignment;
+		size_t             stagingOffset;
+	};
+
+	StreamBuffer<COPY_READ_BUFFER> mStaging;
+	std::vector<BufferWrite>       mBufferWrites;
+	std::vector<TextureWrite>      mTextureWrites;
+	size_t                         mPendingBytes = 0;
+	Stats                          mStats;
+	Stats                          mLastFlush;
+
+	/// Makes room for `bytes` in the staging buffer. Returns false if they'll never fit
+	bool reserve(size_t bytes, size_t alignment) noexcept;
+	void submit() noexcept;
+	void texSubimage(TextureWrite w, void const* pixels) noexcept;
+};
+
+} // namespace gl
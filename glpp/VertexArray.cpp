@@ -1,4 +1,5 @@
 #include "VertexArray.hpp"
+#include "Buffer.hpp"
 
 #ifndef GLPP_DECL
 	#define GLPP_DECL
@@ -108,6 +109,14 @@ void VertexArray::bindBuffer(
 {
 	glVertexArrayVertexBuffer(mHandle, bufferBindingIndex, buffer, offset, stride);
 }
+GLPP_DECL
+void VertexArray::bindBuffer(
+	GLuint bufferBindingIndex,
+	BufferSlice const& slice,
+	size_t stride) noexcept
+{
+	glVertexArrayVertexBuffer(mHandle, bufferBindingIndex, slice.handle, slice.offset, stride);
+}
 
 GLPP_DECL
 void VertexArray::attribDivisor(GLuint attributeBinding, GLuint divisor) noexcept {
@@ -8,6 +8,8 @@
 
 namespace gl {
 
+struct BufferSlice;
+
 /// Combines vertex and index buffers as well as the attribute layout in them into an easily bindable thing
 class VertexArray {
 	unsigned mHandle;
@@ -45,6 +47,11 @@ public:
 		GLuint bufferBindingIndex,
 		unsigned buffer,
 		size_t stride, size_t offset = 0) noexcept;
+	/// Binds a range of a buffer, e.g. a gl::BufferHeap allocation
+	void bindBuffer(
+		GLuint bufferBindingIndex,
+		BufferSlice const& slice,
+		size_t stride) noexcept;
 	void attribDivisor(GLuint attributeBinding, GLuint divisor) noexcept;
 	void attribDivisor(std::initializer_list<GLuint> attributeBindings, GLuint divisor) noexcept;
 
@@ -37,4 +37,13 @@ project 'example'
 	kind 'ConsoleApp'
 	files 'example/**'
 	defines 'GLPP_NO_INLINE'
-	links { 'glpp', 'GLEW', 'GL', 'glfw' }
\ No newline at end of file
+	links { 'glpp', 'GLEW', 'GL', 'glfw' }
+
+-- One executable per benchmark
+for _, benchmark in ipairs { 'CopyOverlapping', 'DrawConstants', 'FrameCapture', 'Pipeline', 'S3tc', 'ShaderCompile', 'StreamBuffer', 'TextureLoad' } do
+	project ('benchmark-' .. benchmark)
+		kind 'ConsoleApp'
+		files { 'benchmark/' .. benchmark .. '.cpp', 'benchmark/*.hpp' }
+		defines 'GLPP_NO_INLINE'
+		links { 'glpp', 'GLEW', 'GL', 'glfw' }
+end